@@ -0,0 +1,48 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stdlib.h>
+
+/**
+ * An Allocator is a vtable of heap operations plus a user pointer that
+ * is passed back to every operation. It lets Vec (and so Str, StrVec,
+ * Command) and Node route their allocations to arenas, pools or
+ * instrumented allocators instead of calloc/realloc/free.
+ *
+ * Sizes are passed to realloc and free so that allocators which do not
+ * track block sizes themselves (e.g. arenas) can still be implemented.
+ */
+typedef struct Allocator {
+    void* (*alloc)(void *user, size_t size);
+    void* (*realloc)(void *user, void *ptr, size_t old_size, size_t new_size);
+    void (*free)(void *user, void *ptr, size_t size);
+    void *user;
+} Allocator;
+
+/**
+ * Returns the Allocator backed by the C library's malloc/realloc/free.
+ */
+const Allocator* Allocator_system(void);
+
+/**
+ * Returns the Allocator used by constructors that are not handed one
+ * explicitly. This is the system allocator unless replaced.
+ */
+const Allocator* Allocator_default(void);
+
+/**
+ * Replace the default Allocator. Passing NULL restores the system
+ * allocator. Values constructed before the change keep the Allocator
+ * they were constructed with, so the Allocator must outlive them.
+ */
+void Allocator_set_default(const Allocator *allocator);
+
+/* Dispatch helpers. Results are not OOM guarded. */
+
+void* Allocator_alloc(const Allocator *self, size_t size);
+
+void* Allocator_realloc(const Allocator *self, void *ptr, size_t old_size, size_t new_size);
+
+void Allocator_free(const Allocator *self, void *ptr, size_t size);
+
+#endif
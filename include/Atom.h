@@ -0,0 +1,72 @@
+#ifndef ATOM_H
+#define ATOM_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "StrView.h"
+#include "TypedVec.h"
+
+/**
+ * Atom - an interned, immutable string.
+ *
+ * Interning the same chars always yields the same Atom pointer, so
+ * atoms compare equal exactly when their pointers do. Each Atom caches
+ * its hash (Map_hash_bytes of its chars) and a null terminated copy of
+ * its chars. Atoms live in one process-wide table and remain valid until
+ * Atom_release_all; there is no per-Atom drop.
+ */
+typedef struct Atom {
+    uint64_t hash;
+    size_t length;
+    const char *chars;
+} Atom;
+
+typedef const Atom *AtomRef;
+
+/* AtomVec is a Vector of Atom pointers: AtomVec_at, AtomVec_append, ... */
+typedef Vec AtomVec;
+VEC_DEFINE(AtomRef, AtomVec)
+
+/**
+ * Returns the Atom for `length` bytes, interning a copy of them first
+ * if they have not been interned before.
+ */
+const Atom* Atom_intern(const char *bytes, size_t length);
+
+/**
+ * Atom_intern over the chars of a C-string or a StrView.
+ */
+const Atom* Atom_intern_cstr(const char *cstr);
+const Atom* Atom_intern_view(const StrView *view);
+
+/**
+ * Returns the Atom for `length` bytes if they have been interned,
+ * otherwise NULL. Never inserts.
+ */
+const Atom* Atom_find(const char *bytes, size_t length);
+
+/**
+ * Borrow the chars of an Atom.
+ */
+const char* Atom_cstr(const Atom *self);
+StrView Atom_view(const Atom *self);
+
+/**
+ * Returns the Atom whose chars Atom_cstr returned. Passing any other
+ * pointer is undefined.
+ */
+const Atom* Atom_of_cstr(const char *chars);
+
+/**
+ * Returns the number of distinct atoms interned.
+ */
+size_t Atom_count(void);
+
+/**
+ * Free every Atom and empty the table. Every Atom pointer handed out
+ * before the call is invalidated.
+ */
+void Atom_release_all(void);
+
+#endif
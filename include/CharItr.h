@@ -4,15 +4,23 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include "Guards.h"
+#include "Kernels.h"
 #include "Str.h"
+#include "StrView.h"
 
 /* 
- * A CharItr is an iterator over an array of char data.
+ * A CharItr is an iterator over an array of char data, or over the
+ * buffered window of a CharStream (see CharStream.h), which it refills
+ * as the cursor reaches the end of the window.
  */
 
+struct CharStream;
+
 typedef struct CharItr {
     const char *cursor;
     const char *sentinel;
+    struct CharStream *stream; /* NULL unless streaming */
 } CharItr;
 
 /*
@@ -30,6 +38,19 @@ CharItr CharItr_value(const char *start, size_t length);
  */
 CharItr CharItr_of_Str(const Str *str);
 
+/**
+ * Get a CharItr over the chars of a StrView. The lifetime of the
+ * CharItr is that of the chars the view borrows.
+ */
+CharItr CharItr_of_StrView(const StrView *view);
+
+/**
+ * Get a CharItr over the input of a CharStream. The CharItr reads more
+ * input from the stream whenever it runs out of buffered chars, and
+ * its lifetime is that of the stream.
+ */
+CharItr CharItr_of_stream(struct CharStream *stream);
+
 /*
  * Returns a pointer to the current location of the iterator's cursor.
  */
@@ -37,16 +58,16 @@ const char* CharItr_cursor(const CharItr *self);
 
 /*
  * Returns true when there are additional characters to consume
- * in the iterable range.
+ * in the iterable range. A streaming CharItr refills to find out.
  */
-bool CharItr_has_next(const CharItr *self);
+bool CharItr_has_next(CharItr *self);
 
 /*
  * Peek and return the next character. Do not advance cursor.
  * Will exit with out of bounds error if no more characters
  * to consume.
  */
-char CharItr_peek(const CharItr *self);
+char CharItr_peek(CharItr *self);
 
 /*
  * Read next character and advance the cursor.
@@ -55,4 +76,51 @@ char CharItr_peek(const CharItr *self);
  */
 char CharItr_next(CharItr *self);
 
+/*
+ * Bulk operations. Each consumes a run of characters in one step and
+ * returns a StrView spanning them in the underlying buffer. For a
+ * streaming CharItr the run may cross refills; the span stays valid
+ * until the next operation on the CharItr.
+ */
+
+/*
+ * Consume characters while they are members of `set`.
+ */
+StrView CharItr_skip_while(CharItr *self, const CharSet *set);
+
+/*
+ * Consume characters up to, but not including, the first member of
+ * `delimiters` or the end of input.
+ */
+StrView CharItr_take_until(CharItr *self, const CharSet *delimiters);
+
+/*
+ * Read more input into a streaming CharItr whose cursor has reached
+ * the end of its buffered chars. Returns false when there is no more
+ * input, or the CharItr is not streaming.
+ *
+ * Refilling moves the buffered chars, so pointers into them from
+ * before the call are invalid afterwards, except for *mark. When mark
+ * is not NULL, the chars from *mark onward are kept and *mark is
+ * updated to their new location.
+ */
+bool CharItr_refill(CharItr *self, const char **mark);
+
+/*
+ * Inline variants of CharItr_peek and CharItr_next for call sites that
+ * have already established CharItr_has_next. Bounds are only verified
+ * in checked builds.
+ */
+static inline char CharItr_peek_unchecked(const CharItr *self)
+{
+    BOUNDS_CHECK(self->cursor < self->sentinel);
+    return *self->cursor;
+}
+
+static inline char CharItr_next_unchecked(CharItr *self)
+{
+    BOUNDS_CHECK(self->cursor < self->sentinel);
+    return *self->cursor++;
+}
+
 #endif
@@ -0,0 +1,57 @@
+#ifndef CHAR_STREAM_H
+#define CHAR_STREAM_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "CharItr.h"
+#include "Vec.h"
+
+/**
+ * A CharStream buffers the chars read from a file descriptor so they
+ * can be consumed through a CharItr (see CharItr_of_stream) without
+ * first holding the whole input in memory.
+ *
+ * The buffer holds a window of the input: the chars not yet consumed,
+ * plus any chars a consumer asked to keep (see CharItr_refill). Each
+ * refill discards the chars before that point, slides the rest to the
+ * front, and reads the next chunk after them, so memory stays at about
+ * one chunk. The buffer grows only when a kept span fills it.
+ */
+typedef struct CharStream {
+    int fd;
+    size_t chunk_size;
+    Vec buffer;
+    bool eof;
+    int error;      /* errno of the read that failed, or 0 */
+    size_t fills;   /* counts fills, each of which moves the buffered chars */
+} CharStream;
+
+/**
+ * Construct a CharStream reading `chunk_size` chars at a time from
+ * `fd`. Owner is responsible for calling CharStream_drop. The fd is not
+ * closed by the CharStream.
+ */
+CharStream CharStream_value(int fd, size_t chunk_size);
+
+void CharStream_drop(CharStream *self);
+
+/**
+ * Discard the buffered chars before `keep`, then read more input after
+ * the chars remaining. `keep` must point into the buffer or at its
+ * end. Returns the number of chars read, 0 once the input is exhausted
+ * or a read has failed. Tell the two apart with CharStream_error.
+ */
+size_t CharStream_fill(CharStream *self, const char *keep);
+
+/**
+ * The errno of the read that ended the input early, or 0 if the input
+ * ended cleanly or has not ended.
+ */
+int CharStream_error(const CharStream *self);
+
+/* The buffered window of input, valid until the next fill */
+const char* CharStream_start(const CharStream *self);
+const char* CharStream_end(const CharStream *self);
+
+#endif
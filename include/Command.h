@@ -0,0 +1,72 @@
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <stdlib.h>
+
+#include "Atom.h"
+#include "Vec.h"
+
+/**
+ * Command - the words of a simple command, packed ready for exec.
+ *
+ * Every word is stored null terminated, back to back, in a single
+ * chars buffer, and argv is kept as a NULL-terminated array of
+ * pointers into it. Handing a Command to execvp needs no per-word work
+ * and touches only those two buffers. When the chars buffer moves as it
+ * grows, argv is rebased onto the new buffer.
+ *
+ * atoms holds the Atom of each word when the words were interned,
+ * otherwise it is empty.
+ */
+typedef struct Command {
+    Vec chars;     /* char: every word followed by its null terminator */
+    Vec argv;      /* char*: a pointer to each word in chars, then NULL */
+    AtomVec atoms;
+} Command;
+
+/**
+ * Construct an empty Command value. Owner is responsible for calling
+ * Command_drop when its lifetime expires.
+ */
+Command Command_value(void);
+
+void Command_drop(Command *self);
+
+/**
+ * Remove every word, keeping the Command's buffers for reuse.
+ */
+void Command_clear(Command *self);
+
+/**
+ * Append a copy of `length` bytes as the next word. `atom` is the
+ * word's Atom, or NULL when words are not interned.
+ */
+void Command_push(Command *self, const char *bytes, size_t length, const Atom *atom);
+
+/**
+ * Returns the bytes of buffer capacity the Command holds, used or not.
+ */
+size_t Command_capacity(const Command *self);
+
+/* Returns the # of words in the Command */
+size_t Command_length(const Command *self);
+
+/**
+ * Returns the word at `index` as a C-string. Attempting to access an
+ * invalid index will result in an out of bounds crash.
+ */
+const char* Command_word(const Command *self, size_t index);
+
+/**
+ * Returns the Atom of the word at `index`, or NULL when the Command's
+ * words were not interned.
+ */
+const Atom* Command_atom(const Command *self, size_t index);
+
+/**
+ * Returns the NULL-terminated argument vector, suitable for execvp.
+ * Valid until the Command is next modified or dropped.
+ */
+char* const* Command_argv(const Command *self);
+
+#endif
@@ -3,4 +3,22 @@
 
 void OOM_GUARD(void *ptr, char *file, int number);
 
+/*
+ * Report an out of bounds access at file:number and exit.
+ */
+void OOB_PANIC(const char *file, int number) __attribute__((noreturn));
+
+/*
+ * Bounds check used by the *_unchecked accessors that back internal
+ * call sites already proven to be in bounds. Checked builds still
+ * verify them; builds with BOUNDS_UNCHECKED defined (the Makefile's
+ * release profile) compile the check away.
+ */
+#ifdef BOUNDS_UNCHECKED
+#define BOUNDS_CHECK(in_bounds) ((void) 0)
+#else
+#define BOUNDS_CHECK(in_bounds) \
+    do { if (!(in_bounds)) { OOB_PANIC(__FILE__, __LINE__); } } while (0)
+#endif
+
 #endif
@@ -0,0 +1,85 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Kernels - the byte-scanning loops underneath Str and the Scanner.
+ *
+ * Each kernel has a scalar implementation plus SSE2 and AVX2
+ * implementations that test a whole vector of chars per iteration.
+ * The widest level the CPU supports is selected once at program
+ * startup; on targets other than x86 only the scalar level exists.
+ */
+
+typedef enum KernelLevel {
+    KERNEL_SCALAR = 0,
+    KERNEL_SSE2 = 1,
+    KERNEL_AVX2 = 2
+} KernelLevel;
+
+/* The most chars a CharSet can hold */
+#define CHAR_SET_MAX 16
+
+/**
+ * A small set of chars to search for or skip over. Vector kernels test
+ * every member against a block of input, so sets are kept small. A
+ * CharSet may contain '\0'. Can be initialized statically:
+ *
+ *  static const CharSet SPACES = { 3, " \t\n" };
+ */
+typedef struct CharSet {
+    size_t count;
+    char chars[CHAR_SET_MAX];
+} CharSet;
+
+/**
+ * Construct a CharSet of the first `count` chars of `chars`. Sets
+ * larger than CHAR_SET_MAX result in an out of bounds crash.
+ */
+CharSet CharSet_value(const char *chars, size_t count);
+
+/**
+ * Returns the level of the kernels currently in use.
+ */
+KernelLevel Kernel_level(void);
+
+/**
+ * Use the kernels of `level`, or of the widest supported level below
+ * it when the CPU does not support `level`. Returns the level applied.
+ * Intended for tests and benchmarks comparing implementations.
+ */
+KernelLevel Kernel_set_level(KernelLevel level);
+
+/**
+ * Returns the number of chars in a null terminated C-string.
+ */
+size_t Kernel_length(const char *cstr);
+
+/**
+ * Returns the index of the first of `length` bytes that is a member of
+ * `set`, or `length` when there is none.
+ */
+size_t Kernel_find_any(const char *bytes, size_t length, const CharSet *set);
+
+/**
+ * Returns the index of the first of `length` bytes that is not a
+ * member of `set`, or `length` when every byte is.
+ */
+size_t Kernel_skip_while(const char *bytes, size_t length, const CharSet *set);
+
+/**
+ * Returns true when the first `length` bytes of `a` and `b` are equal.
+ */
+bool Kernel_equals(const void *a, const void *b, size_t length);
+
+/**
+ * Classify `length` bytes by membership of `set`, 64 at a time. Bit j
+ * of bits[i] is set when bytes[64 * i + j] is a member. `bits` must
+ * have room for (length + 63) / 64 words; bits past `length` are clear.
+ */
+void Kernel_classify(const char *bytes, size_t length, const CharSet *set, uint64_t *bits);
+
+#endif
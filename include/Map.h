@@ -0,0 +1,151 @@
+#ifndef MAP_H
+#define MAP_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Allocator.h"
+
+/**
+ * Map - an open addressing hash map from keys of any type to values
+ * of any type.
+ *
+ * Entries live in a flat slot array next to an array of one byte of
+ * metadata per slot. A metadata byte is EMPTY, DELETED, or holds the
+ * low 7 bits of a full slot's key hash. Lookups scan the metadata a
+ * group of MAP_GROUP_WIDTH bytes at a time with word-wide bit tricks,
+ * and only compare keys for slots whose 7 hash bits match, in the
+ * style of Swiss tables.
+ */
+
+/* Number of metadata bytes examined at once while probing */
+#define MAP_GROUP_WIDTH 8
+
+/* Hash a key. Should mix well across all 64 bits. */
+typedef uint64_t (*MapHash)(const void *key);
+
+/* Compare two keys for equality. */
+typedef bool (*MapEquals)(const void *key, const void *other);
+
+/* Compare a stored key against a lookup probe of some other type. */
+typedef bool (*MapMatches)(const void *key, const void *probe);
+
+/* Release any resources a key owns. */
+typedef void (*MapDropKey)(void *key);
+
+/**
+ * The Map struct is a "thick pointer". Users of Map should not access
+ * these members directly! Instead, use the operations below.
+ */
+typedef struct Map {
+    size_t key_size;     /* size of a key in bytes */
+    size_t value_size;   /* size of a value in bytes */
+    size_t value_offset; /* offset of the value within a slot */
+    size_t slot_size;    /* size of a slot in bytes */
+    size_t length;       /* number of entries in Map */
+    size_t capacity;     /* number of slots, zero or a power of two */
+    size_t growth_left;  /* inserts remaining before a rehash */
+    uint8_t *control;    /* capacity + MAP_GROUP_WIDTH metadata bytes */
+    void *slots;         /* capacity slots of key then value */
+    MapHash hash;
+    MapEquals equals;
+    MapDropKey drop_key; /* NULL when keys own nothing */
+    const Allocator *allocator;
+} Map;
+
+/* Constructor / Destructor */
+
+/**
+ * Construct an empty Map value. No memory is allocated until the first
+ * insertion. Owner is responsible for calling Map_drop when its
+ * lifetime expires.
+ *
+ * @param key_size - sizeof an individual key
+ * @param value_size - sizeof an individual value
+ * @param hash - hash function over keys
+ * @param equals - equality function over keys
+ * @param drop_key - called on keys the Map discards, or NULL
+ */
+Map Map_value(
+        size_t key_size,
+        size_t value_size,
+        MapHash hash,
+        MapEquals equals,
+        MapDropKey drop_key
+    );
+
+/**
+ * Construct an empty Map keyed by Str. The Map owns its Str keys and
+ * drops them when they are removed or the Map is dropped.
+ */
+Map Map_str_value(size_t value_size);
+
+/**
+ * Owner must call to expire a Map value's lifetime. Drops every key
+ * and frees any heap memory the Map owns.
+ */
+void Map_drop(Map *self);
+
+/* Accessors */
+
+/**
+ * Returns the number of entries in the Map.
+ */
+size_t Map_length(const Map *self);
+
+/**
+ * Returns a pointer to the value stored for `key`, or NULL when there
+ * is none. You may write to this reference, but not beyond it. Its
+ * lifetime expires with the next insertion or removal.
+ */
+void* Map_get(const Map *self, const void *key);
+
+/**
+ * Lookup with a probe of a type other than the key type. `hash` must
+ * be the hash the Map's hash function would produce for a matching
+ * key. Returns a pointer to the value, or NULL.
+ */
+void* Map_find(const Map *self, uint64_t hash, MapMatches matches, const void *probe);
+
+/**
+ * Lookup in a Map made by Map_str_value by the bytes of a string,
+ * without constructing a Str.
+ */
+void* Map_get_str(const Map *self, const char *bytes, size_t length);
+
+/* Operations */
+
+/**
+ * Associate a copy of `value` with `key`. When `key` is new, the Map
+ * takes ownership of the key. When an equal key is already present its
+ * value is overwritten, and the Map drops the redundant `key`.
+ * Returns a pointer to the stored value with Map_get's lifetime.
+ */
+void* Map_set(Map *self, const void *key, const void *value);
+
+/**
+ * Remove the entry for `key`, dropping the stored key. When `value_out`
+ * is not NULL the removed value is copied to it. Returns true when an
+ * entry was removed.
+ */
+bool Map_remove(Map *self, const void *key, void *value_out);
+
+/**
+ * Iterate over the entries of the Map. Start with `*cursor` at 0; each
+ * call stores the next entry's key and value references and returns
+ * true, or returns false once every entry has been visited. Entries
+ * are visited in no particular order. The Map must not be mutated
+ * during iteration.
+ */
+bool Map_next(const Map *self, size_t *cursor, void **key, void **value);
+
+/* Hashing */
+
+/**
+ * Hash an array of bytes. This is the hash Map_str_value uses for its
+ * keys' contents.
+ */
+uint64_t Map_hash_bytes(const void *bytes, size_t length);
+
+#endif
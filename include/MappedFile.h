@@ -0,0 +1,41 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "CharItr.h"
+
+/**
+ * A MappedFile is a read-only memory mapping of a whole file, advised
+ * for sequential access, so its chars can be scanned in place without
+ * being read or copied into a buffer first.
+ */
+typedef struct MappedFile {
+    const char *bytes;
+    size_t length;
+} MappedFile;
+
+/**
+ * Map the file at `path`. Returns false, with errno set, if the file
+ * cannot be opened or mapped. On success the owner is responsible for
+ * calling MappedFile_drop.
+ */
+bool MappedFile_open(const char *path, MappedFile *out);
+
+/**
+ * Map the file open on `fd`, which the caller still owns and may close
+ * once this returns. Only a regular file has a size to map: anything
+ * else, such as a pipe, FIFO or terminal, fails with errno ENODEV and
+ * is left unread, so that it can be read through a CharStream instead.
+ */
+bool MappedFile_open_fd(int fd, MappedFile *out);
+
+void MappedFile_drop(MappedFile *self);
+
+/**
+ * Get a CharItr over the whole file. Its lifetime is the mapping's.
+ */
+CharItr CharItr_of_MappedFile(const MappedFile *file);
+
+#endif
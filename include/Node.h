@@ -1,8 +1,8 @@
 #ifndef NODE_H
 #define NODE_H
 
-#include "Str.h"
-#include "StrVec.h"
+#include "Allocator.h"
+#include "Command.h"
 
 typedef enum NodeType {
     ERROR_NODE = -1,
@@ -14,7 +14,7 @@ typedef struct Node Node;
 
 typedef const char* ErrorValue;
 
-typedef StrVec CommandValue;
+typedef Command CommandValue;
 
 typedef struct PipeValue {
     Node *left;
@@ -30,16 +30,28 @@ typedef union NodeValue {
 struct Node {
     NodeType type;
     NodeValue data;
+    const Allocator *allocator; /* source of this Node's memory */
 };
 
-/** Node Constructorsand Destructor  */
+/** Node Constructors and Destructor
+ *
+ * Nodes are allocated from Allocator_default() at construction time
+ * and returned to the same Allocator by Node_drop.
+ */
 
 Node* ErrorNode_new(const char *msg);
 
-Node* CommandNode_new(StrVec words);
+Node* CommandNode_new(Command command);
 
 Node* PipeNode_new(Node *left, Node *right);
 
 void* Node_drop(Node *self);
 
+/**
+ * Like Node_drop, but hands each COMMAND_NODE's Command to
+ * `drop_command`, which becomes responsible for it, rather than
+ * dropping it.
+ */
+void* Node_drop_with(Node *self, void (*drop_command)(Command *command));
+
 #endif
@@ -9,7 +9,42 @@
  * the root of the parse tree. The caller of `parse`
  * owns the resulting `Node*` and is responsible for
  * calling `Node_drop` to free its allocated memory.
+ * Tokens are taken from the Scanner in batches, so on
+ * an error the rest of the line may be consumed.
  */
 Node* parse(Scanner *s);
 
+/**
+ * Parse the Tokens of one line from an array, such as one filled by
+ * Scanner_fill, reading them by index. Parsing stops at `count` Tokens
+ * or at an END_TOKEN. The Tokens are only read during the call.
+ */
+Node* parse_tokens(const Token *tokens, size_t count);
+
+/**
+ * Scan and parse the chars of a StrView. The view is only read
+ * during the call; the resulting tree owns copies of its words.
+ */
+Node* parse_view(const StrView *input);
+
+/**
+ * Command buffers that have grown past this many bytes are not kept by
+ * `parse_recycle`, so that an outlier line's memory is returned rather
+ * than held for the rest of a session.
+ */
+#define PARSE_HIGH_WATER (64 * 1024)
+
+/**
+ * Drop a parse tree, keeping the buffers of its commands so that later
+ * calls to `parse` can fill them rather than allocate new ones. Use in
+ * place of `Node_drop` when parsing line after line. The kept buffers
+ * are shared by the whole process, so only recycle from one thread.
+ */
+void parse_recycle(Node *tree);
+
+/**
+ * Free the command buffers held for reuse by `parse_recycle`.
+ */
+void parse_release(void);
+
 #endif
@@ -2,29 +2,80 @@
 #define SCANNER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "CharItr.h"
+#include "Atom.h"
 #include "Str.h"
+#include "StrView.h"
+#include "StructuralIndex.h"
 
 /** Token Definitions */
 
 typedef enum TokenType {
     END_TOKEN = -1,
     WORD_TOKEN = 0,
-    PIPE_TOKEN = 1
+    PIPE_TOKEN = 1,         /* |    */
+    OR_TOKEN = 2,           /* ||   */
+    AND_TOKEN = 3,          /* &&   */
+    BACKGROUND_TOKEN = 4,   /* &    */
+    REDIRECT_OUT_TOKEN = 5, /* >    */
+    APPEND_TOKEN = 6,       /* >>   */
+    REDIRECT_IN_TOKEN = 7,  /* <    */
+    DUP_TOKEN = 8           /* 2>&1 */
 } TokenType;
 
+/**
+ * A Token is a span of its lexeme's chars rather than a copy of them.
+ * The span borrows the Scanner's input: an in-memory input outlives its
+ * Tokens, but a streaming input reuses its buffer, so a streamed Token
+ * is only valid until the next call on its Scanner. Interned Tokens
+ * borrow the chars of their Atom instead, which live until
+ * Atom_release_all. Use Token_to_Str for a lexeme that must outlive
+ * these.
+ */
 typedef struct Token {
-    TokenType type;
-    Str lexeme;
+    const char *start;
+    uint32_t length;        /* a longer lexeme is a fatal error */
+    int8_t type;            /* a TokenType */
+    bool interned;          /* start is the chars of an Atom; see Token_atom */
+    bool quoted;            /* a WORD_TOKEN written with quotes or \ escapes */
 } Token;
 
+/**
+ * Borrow a view of a Token's lexeme, valid for as long as the Token.
+ * The view of a quoted word is its chars as written, quotes included.
+ */
+StrView Token_view(const Token *self);
+
+/**
+ * Copy a Token's lexeme into a Str that the caller owns. A quoted word
+ * is copied without its quoting: '' keeps every char between its quotes,
+ * "" keeps them but lets \ escape " \ $ and `, and a \ elsewhere
+ * escapes the char after it.
+ */
+Str Token_to_Str(const Token *self);
+
+/**
+ * The Atom of an interned WORD_TOKEN's lexeme, or NULL.
+ */
+const Atom* Token_atom(const Token *self);
+
 /** 
  * Scanner is a peekable iterator that produces Tokens from a CharItr input.
+ * It produces the Tokens of one line at a time: a newline ends the line
+ * with an END_TOKEN, and Scanner_next_line moves on to the next line.
  **/
 
 typedef struct Scanner {
     CharItr char_itr;
     Token next;
+    bool taken;             /* next was handed out; scan again before use */
+    bool interning;
+    bool indexed;           /* large in-memory input: see StructuralIndex.h */
+    StructuralIndex index;
+    const char *newline;    /* a streamed line's buffered newline, or the end
+                               of the buffer if it has none; see Scanner_fill */
+    size_t newline_fills;   /* the stream's fills when newline was found */
 } Scanner;
 
 /**
@@ -32,26 +83,119 @@ typedef struct Scanner {
  **/
 Scanner Scanner_value(CharItr char_itr);
 
+/**
+ * A Scanner whose WORD_TOKENs also carry the Atom of their lexeme,
+ * so that later stages can compare words by pointer. See Atom.h.
+ **/
+Scanner Scanner_interning(CharItr char_itr);
+
+/**
+ * Point a Scanner at a new input, discarding whatever was left of the
+ * old one. The Scanner keeps its interning setting and reuses its
+ * lookahead and index storage, so one Scanner can serve every line of
+ * a session.
+ **/
+void Scanner_reset(Scanner *self, CharItr char_itr);
+
+/**
+ * Release a Scanner. Tokens borrow rather than own their chars, so this
+ * only detaches the Scanner from its input: afterwards it has no next
+ * Token.
+ **/
+void Scanner_drop(Scanner *self);
+
 /**
  * Scanner_has_next returns true when there is another Token to
  * peek or take with next, false otherwise.
  */
-bool Scanner_has_next(const Scanner *self);
+bool Scanner_has_next(Scanner *self);
 
 /**
- * Peek the next Token without advancing the Scanner. The Scanner
- * still owns the Token (and, importantly, its lexeme Str).
+ * Peek the next Token without advancing the Scanner.
  */
-Token Scanner_peek(const Scanner *self);
+Token Scanner_peek(Scanner *self);
 
 /**
- * Take the next Token and advance the Scanner. The caller of
- * Scanner_next owns the returned Token and is responsible for
- * calling Str_drop on its lexeme Str. 
+ * Take the next Token and advance the Scanner. Tokens own no memory,
+ * so there is nothing to drop. The Scanner only scans the Token after
+ * it once it is next asked for one, which keeps a streamed Token's
+ * chars in the buffer until then.
  *
- * When there are no more tokens in the stream, return a token of
- * END_TOKEN type with an empty Str lexeme.
+ * When there are no more tokens in the line, return a token of
+ * END_TOKEN type with an empty lexeme.
  */
 Token Scanner_next(Scanner *self);
 
+/**
+ * Take up to `max` Tokens of the current line at once into `out`,
+ * returning how many were taken. Returns 0 at the end of the line.
+ * Tokens are valid as for Scanner_next. Because a refill would move the
+ * chars of a streamed batch, a streaming Scanner only takes more than
+ * one Token when the rest of the line is already buffered.
+ */
+size_t Scanner_fill(Scanner *self, Token *out, size_t max);
+
+/**
+ * Discard any Tokens left in the current line and move on to the next
+ * line. Returns true when there is another line, false at the end of
+ * the input. A '\0' ends its line's Tokens with an END_TOKEN, and the
+ * rest of that line is discarded with them.
+ */
+bool Scanner_next_line(Scanner *self);
+
+/**
+ * PushScanner is the resumable counterpart of Scanner. Rather than
+ * pulling chars from a CharItr, it is fed input in chunks of any size,
+ * straight from a read buffer, and scans as far as each chunk goes. A
+ * token split between chunks is carried over and completed from the
+ * next chunk, which only copies the split token's chars.
+ *
+ * Unlike Scanner, a newline is consumed with its END_TOKEN, so the
+ * Tokens of one line simply follow those of the previous one.
+ **/
+
+typedef enum ScanResult {
+    SCAN_TOKEN,         /* a Token was produced */
+    SCAN_NEED_INPUT     /* the chunk is used up: feed another, or finish */
+} ScanResult;
+
+typedef struct PushScanner {
+    CharItr chunk;          /* the unscanned rest of the last chunk fed */
+    bool finished;          /* no more chunks will be fed */
+    Str carry;              /* chars of a token split between chunks */
+    size_t carry_scanned;   /* carry chars already run through the state machine */
+    size_t emitted;         /* carry chars of the last Token, dropped by the next call */
+    uint8_t state;          /* of the token in progress, 0 between tokens */
+    int8_t type;            /* longest token accepted so far */
+    size_t accepted;        /* and its length */
+} PushScanner;
+
+/**
+ * A PushScanner with no input yet. Drop with PushScanner_drop.
+ **/
+PushScanner PushScanner_value(void);
+
+void PushScanner_drop(PushScanner *self);
+
+/**
+ * Feed the next chunk of input. Only feed after PushScanner_next has
+ * returned SCAN_NEED_INPUT. The chunk is borrowed, and Tokens may point
+ * into it, so keep it unchanged until the next feed.
+ **/
+void PushScanner_feed(PushScanner *self, const char *chunk, size_t length);
+
+/**
+ * Declare the end of input, so that a token at the end of the last
+ * chunk is completed rather than waited on.
+ **/
+void PushScanner_finish(PushScanner *self);
+
+/**
+ * Scan the next Token into `out` and return SCAN_TOKEN, or return
+ * SCAN_NEED_INPUT when the chunk runs out first. A Token is valid until
+ * the next call on the PushScanner. After PushScanner_finish, the end
+ * of input produces END_TOKENs.
+ **/
+ScanResult PushScanner_next(PushScanner *self, Token *out);
+
 #endif
@@ -2,6 +2,7 @@
 #define STR_H
 
 #include "Vec.h"
+#include "TypedVec.h"
 
 /**
  * Str is just an alias of Vec to make its purpose of storing
@@ -9,12 +10,33 @@
  */
 typedef Vec Str;
 
+/* Typed char accessors over a Str's buffer: CharVec_at, CharVec_load, ... */
+VEC_DEFINE(char, CharVec)
+
 /**
  * Construct an empty Str value. Owner is responsible for calling
  * Str_drop when its lifetime expires.
  */
 Str Str_value(size_t capacity);
 
+/**
+ * Construct an empty Str value whose characters are stored inline in
+ * the Str itself until they outgrow VEC_INLINE_BYTES (including the
+ * null terminator), avoiding a heap allocation for short strings.
+ * Pointers returned by Str_ref and Str_cstr expire when an inline Str
+ * value is copied or moved. Owner is responsible for calling Str_drop
+ * when its lifetime expires.
+ */
+Str Str_inline(void);
+
+/**
+ * Construct a new Str value from the first `length` chars of `bytes`
+ * with a single copy. Strings shorter than VEC_INLINE_BYTES are stored
+ * inline, as with Str_inline, and longer ones on the heap. Caller is
+ * responsible for calling Str_drop when its lifetime expires.
+ */
+Str Str_inline_from_n(const char *bytes, size_t length);
+
 /**
  * Owner of a Str must call to expire its buffer data's lifetime.
  * Frees any heap memory the Str owns.
@@ -49,6 +71,15 @@ const char* Str_cstr(const Str *self);
  */
 Str Str_from(const char *cstr);
 
+/**
+ * Construct a new Str value from the first `length` chars of `bytes`,
+ * which need not be null terminated but should not contain a null
+ * character. Copies with a single capacity check and copy, without
+ * scanning for a terminator. Caller is responsible for calling
+ * Str_drop when its lifetime expires.
+ */
+Str Str_from_n(const char *bytes, size_t length);
+
 /**
  * Starting from `index`, remove `delete_count` items from `self`,
  * and insert `insert_count` values from `cstr` at that index of `self`.
@@ -68,6 +99,19 @@ void Str_splice(
  */
 void Str_append(Str *self, const char *cstr);
 
+/**
+ * Append the first `length` chars of `bytes` to a Str with a single
+ * capacity check and copy. `bytes` need not be null terminated but
+ * should not contain a null character.
+ */
+void Str_append_n(Str *self, const char *bytes, size_t length);
+
+/**
+ * Append the contents of another Str to a Str. `other` must not be
+ * `self`.
+ */
+void Str_append_str(Str *self, const Str *other);
+
 /**
  * Get a character at a specific index of the Str.
  */
@@ -7,6 +7,9 @@
 /* StrVec is a Vector of Str values. */
 typedef Vec StrVec;
 
+/* Typed Str accessors over a StrVec's buffer: StrVec_at, StrVec_load, ... */
+VEC_DEFINE(Str, StrVec)
+
 /* Construct an empty StrVec value. Owner is 
  * responsible for calling Str_drop when its 
  * lifetime expires.
@@ -0,0 +1,121 @@
+#ifndef STR_VIEW_H
+#define STR_VIEW_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Str.h"
+
+/**
+ * A StrView is a borrowed, read-only slice of char data: a pointer and
+ * a length. It owns no memory, so there is no drop function, and it
+ * is not null terminated. Its lifetime is that of the chars it refers
+ * to; a view of a Str expires with any mutation or drop of the Str.
+ */
+typedef struct StrView {
+    const char *start;
+    size_t length;
+} StrView;
+
+/* Returned by the find operations when nothing is found */
+#define STR_VIEW_NPOS ((size_t) -1)
+
+/* Constructors */
+
+/**
+ * Construct a view of `length` chars starting at `start`.
+ */
+StrView StrView_value(const char *start, size_t length);
+
+/**
+ * Construct a view of a C-string, not including its null terminator.
+ */
+StrView StrView_from_cstr(const char *cstr);
+
+/**
+ * Construct a view of a Str's chars, not including its null terminator.
+ */
+StrView StrView_of_Str(const Str *str);
+
+/**
+ * Copy the viewed chars into a new owned Str value. Caller is
+ * responsible for calling Str_drop when its lifetime expires.
+ */
+Str StrView_to_Str(const StrView *self);
+
+/* Accessors */
+
+size_t StrView_length(const StrView *self);
+
+/**
+ * Get a character at a specific index of the view. Attempting to access
+ * an invalid index will result in an out of bounds crash.
+ */
+char StrView_get(const StrView *self, size_t index);
+
+/**
+ * Returns a view of `length` chars of `self` starting from `index`.
+ * Attempting to slice beyond the end of the view will result in an out
+ * of bounds crash.
+ */
+StrView StrView_slice(const StrView *self, size_t index, size_t length);
+
+/* Comparison and Hashing */
+
+/**
+ * Returns true when both views contain the same chars.
+ */
+bool StrView_equals(const StrView *self, const StrView *other);
+
+/**
+ * Returns true when the view contains the same chars as `cstr`.
+ */
+bool StrView_equals_cstr(const StrView *self, const char *cstr);
+
+/**
+ * Lexicographic comparison. Returns a negative number, zero, or a
+ * positive number as `self` orders before, equal to, or after `other`.
+ */
+int StrView_compare(const StrView *self, const StrView *other);
+
+/**
+ * Hash the viewed chars. Agrees with the hash Map_str_value uses for
+ * Str keys with the same chars.
+ */
+uint64_t StrView_hash(const StrView *self);
+
+/* Searching */
+
+/**
+ * Returns the index of the first occurrence of `c`, or STR_VIEW_NPOS.
+ */
+size_t StrView_find(const StrView *self, char c);
+
+/**
+ * Returns the index of the first char that is any of the chars of the
+ * C-string `set`, or STR_VIEW_NPOS.
+ */
+size_t StrView_find_any(const StrView *self, const char *set);
+
+/**
+ * Returns the index of the first occurrence of `needle`, or
+ * STR_VIEW_NPOS. An empty needle is found at index 0.
+ */
+size_t StrView_find_view(const StrView *self, const StrView *needle);
+
+/* Splitting */
+
+/**
+ * Split fields off the front of `rest` separated by any of the chars of
+ * `delimiters`. Runs of delimiters are skipped. When a field remains,
+ * stores it in `field`, advances `rest` past it, and returns true.
+ * Returns false once only delimiters remain.
+ *
+ * Usage:
+ *  StrView rest = StrView_from_cstr("ls  -l | wc"), word;
+ *  while (StrView_split(&rest, " ", &word)) { ... }
+ */
+bool StrView_split(StrView *rest, const char *delimiters, StrView *field);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef STRUCTURAL_INDEX_H
+#define STRUCTURAL_INDEX_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+/**
+ * StructuralIndex - the first stage of the Scanner's two-stage path for
+ * large in-memory inputs.
+ *
+ * Building an index classifies a window of input 64 chars at a time
+ * into bitmasks of spaces and of structural chars (spaces, newlines,
+ * operator chars, quoting chars and end chars); every other char
+ * belongs to a word.
+ * From those masks it extracts the offset of each word start, each word
+ * end, and each newline, operator or end char, in order. The Scanner
+ * then walks the offsets (the second stage): the chars between two
+ * offsets are either all spaces or the rest of a word, so spaces are
+ * skipped and words are cut without looking at their chars again.
+ *
+ * A window is small and fixed so the index lives inside the Scanner.
+ */
+#define STRUCTURAL_WINDOW 256
+
+typedef struct StructuralIndex {
+    const char *base;  /* first char of the indexed window, NULL before any */
+    uint16_t length;   /* chars indexed from base */
+    uint16_t count;    /* offsets in use */
+    uint16_t next;     /* next offset to visit */
+    uint8_t offsets[STRUCTURAL_WINDOW];
+} StructuralIndex;
+
+/**
+ * Returns an index of no window.
+ */
+StructuralIndex StructuralIndex_value(void);
+
+/**
+ * Index the window of up to STRUCTURAL_WINDOW chars starting at `base`.
+ * `base` must not be in the middle of a word.
+ */
+void StructuralIndex_build(StructuralIndex *self, const char *base, size_t length);
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef TYPED_VEC_H
+#define TYPED_VEC_H
+
+#include "Guards.h"
+#include "Vec.h"
+
+/**
+ * VEC_DEFINE(T, Name) generates a family of inline accessors over a Vec
+ * whose items are of type T. Because sizeof(T) is a compile-time constant,
+ * element access compiles down to a bounds check and a fixed-size load or
+ * store rather than a multiply and variable-length memcpy.
+ *
+ * The generated functions operate on the ordinary Vec struct, so a Vec
+ * constructed with Vec_value(capacity, sizeof(T)) may be used through
+ * both the untyped Vec API and its typed accessors interchangeably.
+ *
+ * Usage: VEC_DEFINE(char, CharVec) generates
+ *  T*   CharVec_at(const Vec *self, size_t index)
+ *  T*   CharVec_at_unchecked(const Vec *self, size_t index)
+ *  T    CharVec_load(const Vec *self, size_t index)
+ *  void CharVec_store(Vec *self, size_t index, T value)
+ *  void CharVec_append(Vec *self, T value)
+ *
+ * The same bounds rules as Vec_ref, Vec_get and Vec_set apply, except
+ * that _at_unchecked, meant for call sites already proven in bounds,
+ * only verifies its index in checked builds (see BOUNDS_CHECK).
+ */
+#define VEC_DEFINE(T, Name)                                                 \
+                                                                            \
+static inline T* Name##_at(const Vec *self, size_t index)                   \
+{                                                                           \
+    if (index >= self->length) {                                            \
+        OOB_PANIC(__FILE__, __LINE__);                                      \
+    }                                                                       \
+    return ((T*) Vec_data(self)) + index;                                   \
+}                                                                           \
+                                                                            \
+static inline T* Name##_at_unchecked(const Vec *self, size_t index)         \
+{                                                                           \
+    BOUNDS_CHECK(index < self->length);                                     \
+    return ((T*) Vec_data(self)) + index;                                   \
+}                                                                           \
+                                                                            \
+static inline T Name##_load(const Vec *self, size_t index)                  \
+{                                                                           \
+    return *Name##_at(self, index);                                         \
+}                                                                           \
+                                                                            \
+static inline void Name##_append(Vec *self, T value)                        \
+{                                                                           \
+    if (self->length < self->capacity) {                                    \
+        ((T*) Vec_data(self))[self->length++] = value;                      \
+    } else {                                                                \
+        Vec_push(self, &value);                                             \
+    }                                                                       \
+}                                                                           \
+                                                                            \
+static inline void Name##_store(Vec *self, size_t index, T value)           \
+{                                                                           \
+    if (index == self->length) {                                            \
+        Name##_append(self, value);                                         \
+    } else {                                                                \
+        *Name##_at(self, index) = value;                                    \
+    }                                                                       \
+}
+
+#endif
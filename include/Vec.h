@@ -3,36 +3,77 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "Allocator.h"
 
 /**
  * Vec - a dynamically growable array of any type.
  */
 
+/*
+ * Bytes of item storage a Vec carries inline before spilling to the heap.
+ * Sized so that an inline Str holds 23 chars plus its null terminator
+ * while the whole Vec stays 64 bytes, one cache line.
+ */
+#define VEC_INLINE_BYTES 24
+
 /**
  * The Vec struct is a "thick pointer".
  *
  * Users of Vec should not access these members directly!
  * Instead, use the operations exposed in the functions below.
+ *
+ * A Vec constructed with Vec_inline stores its items in inline_buffer,
+ * signalled by a NULL buffer, until they outgrow it. Because the items
+ * then move with the Vec value itself, references into an inline Vec
+ * expire whenever the Vec value is copied or moved.
  */
 typedef struct Vec {
-    size_t item_size; /* size of an item in bytes */
-    size_t length;    /* number of items in Vec */
-    size_t capacity;  /* number of items buffer can store */
-    void *buffer;     /* heap memory storing items */
+    uint32_t item_size; /* size of an item in bytes */
+    bool mapped;        /* buffer is an anonymous memory mapping */
+    size_t length;      /* number of items in Vec */
+    size_t capacity;    /* number of items buffer can store */
+    void *buffer;       /* heap memory storing items, NULL while inline */
+    const Allocator *allocator; /* source of buffer's heap memory */
+    unsigned char inline_buffer[VEC_INLINE_BYTES]; /* small item storage */
 } Vec;
 
 /* Constructor / Destructor */
 
 /**
- * Construct a Vec value. Owner is responsible for calling
- * Vec_drop when its lifetime expires.
+ * Construct a Vec value whose heap memory comes from Allocator_default().
+ * Owner is responsible for calling Vec_drop when its lifetime expires.
  *
  * @param capacity - initial number of items it can store
- * @param item_size - sizeof an individual item
+ * @param item_size - sizeof an individual item, at most UINT32_MAX
  * @return initialized Vec value.
  */
 Vec Vec_value(size_t capacity, size_t item_size);
 
+/**
+ * Construct a Vec value whose heap memory comes from `allocator`
+ * rather than Allocator_default(). The allocator must outlive the Vec.
+ * Owner is responsible for calling Vec_drop when its lifetime expires.
+ *
+ * @param capacity - initial number of items it can store
+ * @param item_size - sizeof an individual item, at most UINT32_MAX
+ * @param allocator - source of the Vec's heap memory
+ * @return initialized Vec value.
+ */
+Vec Vec_value_in(size_t capacity, size_t item_size, const Allocator *allocator);
+
+/**
+ * Construct an empty Vec value whose items are stored inline in the
+ * Vec itself, without any heap allocation, until they outgrow
+ * VEC_INLINE_BYTES. Owner is responsible for calling Vec_drop when
+ * its lifetime expires.
+ *
+ * @param item_size - sizeof an individual item, at most UINT32_MAX
+ * @return initialized Vec value.
+ */
+Vec Vec_inline(size_t item_size);
+
 /**
  * Owner must call to expire a Vec value's lifetime.
  * Frees any heap memory the Vec owns.
@@ -47,6 +88,20 @@ void Vec_drop(Vec *self);
  */
 size_t Vec_length(const Vec *self);
 
+/**
+ * Returns the number of items the Vec can store before it must grow.
+ */
+size_t Vec_capacity(const Vec *self);
+
+/**
+ * Returns a pointer to the first item slot of the Vec's storage,
+ * whether it lives inline or on the heap. Same lifetime as Vec_ref.
+ */
+static inline void* Vec_data(const Vec *self)
+{
+    return self->buffer != NULL ? self->buffer : (void*) self->inline_buffer;
+}
+
 /**
  * Get a pointer to the item at `index`. You may
  * write to this reference, but not beyond it.
@@ -111,4 +166,99 @@ void Vec_splice(
         size_t insert_count
         );
 
+/* Bulk Operations */
+
+/**
+ * Ensure the Vec's buffer can store at least `capacity` items without
+ * relocating. Never shrinks the buffer.
+ */
+void Vec_reserve(Vec *self, size_t capacity);
+
+/**
+ * Append `count` items from `items` to the end of the Vec with a single
+ * capacity check and copy. All items appended become owned by the `Vec`.
+ */
+void Vec_extend(Vec *self, const void *items, size_t count);
+
+/**
+ * Append a copy of the item pointed to by `item` to the end of the Vec.
+ */
+void Vec_push(Vec *self, const void *item);
+
+/**
+ * Shorten the Vec to `length` items. Capacity is retained, and items
+ * beyond `length` are forgotten without being dropped. Attempting to
+ * truncate to a length greater than the Vec's length will result in an
+ * out of bounds crash.
+ */
+void Vec_truncate(Vec *self, size_t length);
+
+/**
+ * Returns a pointer to the first unused item slot, just past the Vec's
+ * last item, so that up to capacity - length items can be written in
+ * place, as by read(2), and then adopted with Vec_set_length. Same
+ * lifetime as Vec_ref.
+ */
+void* Vec_spare(const Vec *self);
+
+/**
+ * Set the Vec's length to `length` items. Items gained beyond the old
+ * length must have been written through Vec_spare first. Attempting to
+ * set a length greater than the Vec's capacity will result in an out
+ * of bounds crash.
+ */
+void Vec_set_length(Vec *self, size_t length);
+
+/* Capacity Policy */
+
+/**
+ * VecGrowth controls how much capacity a Vec acquires when it runs out
+ * of space. When `needed` items no longer fit, the new capacity is
+ * needed * factor_numerator / factor_denominator (never less than
+ * needed), and then the buffer's byte size is rounded up to a multiple
+ * of `round_bytes` so that requests line up with the allocator's size
+ * classes. A `round_bytes` of 0 disables rounding.
+ *
+ * Large-buffer mode: once a Vec using the system allocator would grow
+ * to `map_threshold` bytes or more, its buffer moves to an anonymous
+ * mmap mapping. From then on it grows and shrinks with mremap, which
+ * remaps pages instead of copying them, and Vec_drop unmaps the pages
+ * outright. A `map_threshold` of 0 disables large-buffer mode.
+ *
+ * The default policy is { 2, 1, 0, 0 }: double what is needed, no
+ * rounding, no large-buffer mode.
+ */
+typedef struct VecGrowth {
+    size_t factor_numerator;
+    size_t factor_denominator;
+    size_t round_bytes;
+    size_t map_threshold;
+} VecGrowth;
+
+/**
+ * Returns the growth policy currently used by every Vec.
+ */
+VecGrowth Vec_growth(void);
+
+/**
+ * Replace the growth policy used by every Vec. Passing NULL restores
+ * the default policy. Returns false, keeping the current policy, when
+ * `growth` has a factor_denominator of 0 or a factor below 1.
+ */
+bool Vec_set_growth(const VecGrowth *growth);
+
+/**
+ * Release unused capacity so that the Vec's buffer holds at most
+ * max(length, `capacity`) items. Never grows the buffer. When that
+ * many items fit in VEC_INLINE_BYTES, the items move inline and the heap
+ * buffer is freed, so references into it then follow the inline
+ * lifetime rules.
+ */
+void Vec_shrink_to(Vec *self, size_t capacity);
+
+/**
+ * Release all unused capacity. Equivalent to Vec_shrink_to(self, 0).
+ */
+void Vec_shrink_to_fit(Vec *self);
+
 #endif
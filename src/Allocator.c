@@ -0,0 +1,63 @@
+#include <stdlib.h>
+
+#include "Allocator.h"
+
+static void* _system_alloc(void *user, size_t size);
+static void* _system_realloc(void *user, void *ptr, size_t old_size, size_t new_size);
+static void _system_free(void *user, void *ptr, size_t size);
+
+static const Allocator SYSTEM_ALLOCATOR = {
+    _system_alloc,
+    _system_realloc,
+    _system_free,
+    NULL
+};
+
+static const Allocator *default_allocator = &SYSTEM_ALLOCATOR;
+
+const Allocator* Allocator_system(void)
+{
+    return &SYSTEM_ALLOCATOR;
+}
+
+const Allocator* Allocator_default(void)
+{
+    return default_allocator;
+}
+
+void Allocator_set_default(const Allocator *allocator)
+{
+    default_allocator = allocator != NULL ? allocator : &SYSTEM_ALLOCATOR;
+}
+
+void* Allocator_alloc(const Allocator *self, size_t size)
+{
+    return self->alloc(self->user, size);
+}
+
+void* Allocator_realloc(const Allocator *self, void *ptr, size_t old_size, size_t new_size)
+{
+    return self->realloc(self->user, ptr, old_size, new_size);
+}
+
+void Allocator_free(const Allocator *self, void *ptr, size_t size)
+{
+    self->free(self->user, ptr, size);
+}
+
+/* System allocator */
+
+static void* _system_alloc(void *user, size_t size)
+{
+    return malloc(size);
+}
+
+static void* _system_realloc(void *user, void *ptr, size_t old_size, size_t new_size)
+{
+    return realloc(ptr, new_size);
+}
+
+static void _system_free(void *user, void *ptr, size_t size)
+{
+    free(ptr);
+}
@@ -0,0 +1,169 @@
+#include <string.h>
+
+#include "Allocator.h"
+#include "Guards.h"
+#include "Map.h"
+
+#include "Atom.h"
+
+/*
+ * Atoms are bump allocated out of chunks so that a script's many short
+ * words cost a few bytes of header each rather than a heap block each.
+ * An Atom's chars follow it in its chunk. Atoms larger than a chunk get
+ * a chunk of their own. Chunks come from Allocator_default() and, like
+ * Nodes, remember it so they are returned to the same Allocator.
+ */
+#define CHUNK_BYTES 4096
+
+typedef struct Chunk {
+    struct Chunk *next;
+    size_t size;
+    size_t used;
+    const Allocator *allocator; /* source of this Chunk's memory */
+} Chunk;
+
+/* The table is a Map from each AtomRef to itself, found by probing with a StrView */
+static Map table;
+static bool table_ready = false;
+static Chunk *chunks = NULL;
+
+static Map* _table(void);
+static Atom* _alloc_atom(size_t length);
+static uint64_t _atom_hash(const void *key);
+static bool _atom_equals(const void *key, const void *other);
+static bool _atom_matches(const void *key, const void *probe);
+
+const Atom* Atom_intern(const char *bytes, size_t length)
+{
+    Map *atoms = _table();
+    uint64_t hash = Map_hash_bytes(bytes, length);
+    StrView probe = StrView_value(bytes, length);
+    AtomRef *found = (AtomRef*) Map_find(atoms, hash, _atom_matches, &probe);
+    if (found != NULL) {
+        return *found;
+    }
+
+    Atom *atom = _alloc_atom(length);
+    char *chars = (char*) (atom + 1);
+    memcpy(chars, bytes, length);
+    chars[length] = '\0';
+    atom->hash = hash;
+    atom->length = length;
+    atom->chars = chars;
+
+    AtomRef key = atom;
+    Map_set(atoms, &key, &key);
+    return atom;
+}
+
+const Atom* Atom_intern_cstr(const char *cstr)
+{
+    return Atom_intern(cstr, strlen(cstr));
+}
+
+const Atom* Atom_intern_view(const StrView *view)
+{
+    return Atom_intern(view->start, view->length);
+}
+
+const Atom* Atom_find(const char *bytes, size_t length)
+{
+    if (!table_ready) {
+        return NULL;
+    }
+    StrView probe = StrView_value(bytes, length);
+    AtomRef *found = (AtomRef*) Map_find(&table, Map_hash_bytes(bytes, length), _atom_matches, &probe);
+    return found != NULL ? *found : NULL;
+}
+
+const char* Atom_cstr(const Atom *self)
+{
+    return self->chars;
+}
+
+StrView Atom_view(const Atom *self)
+{
+    return StrView_value(self->chars, self->length);
+}
+
+const Atom* Atom_of_cstr(const char *chars)
+{
+    // An Atom's chars follow it in its chunk
+    return (const Atom*) chars - 1;
+}
+
+size_t Atom_count(void)
+{
+    return table_ready ? Map_length(&table) : 0;
+}
+
+void Atom_release_all(void)
+{
+    if (table_ready) {
+        Map_drop(&table);
+        table_ready = false;
+    }
+    while (chunks != NULL) {
+        Chunk *next = chunks->next;
+        Allocator_free(chunks->allocator, chunks, chunks->size);
+        chunks = next;
+    }
+}
+
+static Map* _table(void)
+{
+    if (!table_ready) {
+        table = Map_value(sizeof(AtomRef), sizeof(AtomRef), _atom_hash, _atom_equals, NULL);
+        table_ready = true;
+    }
+    return &table;
+}
+
+static Atom* _alloc_atom(size_t length)
+{
+    // Round up so the next Atom in the chunk stays aligned
+    size_t align = sizeof(uint64_t);
+    size_t bytes = (sizeof(Atom) + length + 1 + align - 1) / align * align;
+
+    if (chunks == NULL || chunks->size - chunks->used < bytes) {
+        size_t size = sizeof(Chunk) + bytes > CHUNK_BYTES ? sizeof(Chunk) + bytes : CHUNK_BYTES;
+        const Allocator *allocator = Allocator_default();
+        Chunk *chunk = (Chunk*) Allocator_alloc(allocator, size);
+        OOM_GUARD(chunk, __FILE__, __LINE__);
+        chunk->allocator = allocator;
+        chunk->size = size;
+        chunk->used = sizeof(Chunk);
+        if (chunks != NULL && size != CHUNK_BYTES) {
+            // An oversized Atom's chunk is full already; keep bumping the current one
+            chunk->next = chunks->next;
+            chunks->next = chunk;
+        } else {
+            chunk->next = chunks;
+            chunks = chunk;
+        }
+        chunk->used += bytes;
+        return (Atom*) ((char*) chunk + chunk->used - bytes);
+    }
+
+    chunks->used += bytes;
+    return (Atom*) ((char*) chunks + chunks->used - bytes);
+}
+
+static uint64_t _atom_hash(const void *key)
+{
+    return (*(const AtomRef*) key)->hash;
+}
+
+static bool _atom_equals(const void *key, const void *other)
+{
+    const Atom *lhs = *(const AtomRef*) key;
+    const Atom *rhs = *(const AtomRef*) other;
+    return lhs->length == rhs->length && memcmp(lhs->chars, rhs->chars, lhs->length) == 0;
+}
+
+static bool _atom_matches(const void *key, const void *probe)
+{
+    const Atom *atom = *(const AtomRef*) key;
+    StrView view = Atom_view(atom);
+    return StrView_equals(&view, (const StrView*) probe);
+}
@@ -1,12 +1,14 @@
 #include <stdio.h>
 
 #include "CharItr.h"
+#include "CharStream.h"
 
 CharItr CharItr_value(const char *start, size_t length)
 {
     CharItr ci = {
         (char*) start,
-        start + length
+        start + length,
+        NULL
     };
     return ci;
 }
@@ -16,17 +18,29 @@ CharItr CharItr_of_Str(const Str *str)
     return CharItr_value(Str_ref(str, 0), Str_length(str));
 }
 
+CharItr CharItr_of_StrView(const StrView *view)
+{
+    return CharItr_value(view->start, view->length);
+}
+
+CharItr CharItr_of_stream(CharStream *stream)
+{
+    CharItr ci = CharItr_value(CharStream_start(stream), 0);
+    ci.stream = stream;
+    return ci;
+}
+
 const char* CharItr_cursor(const CharItr *self)
 {
     return self->cursor;
 }
 
-bool CharItr_has_next(const CharItr *self)
+bool CharItr_has_next(CharItr *self)
 {
-    return self->cursor < self->sentinel;
+    return self->cursor < self->sentinel || CharItr_refill(self, NULL);
 }
 
-char CharItr_peek(const CharItr *self)
+char CharItr_peek(CharItr *self)
 {
     if (CharItr_has_next(self)) {
         return *self->cursor;
@@ -44,3 +58,41 @@ char CharItr_next(CharItr *self) {
         exit(EXIT_FAILURE);
     }
 }
+
+StrView CharItr_skip_while(CharItr *self, const CharSet *set)
+{
+    const char *start = self->cursor;
+    do {
+        self->cursor += Kernel_skip_while(self->cursor, self->sentinel - self->cursor, set);
+    } while (self->cursor == self->sentinel && CharItr_refill(self, &start));
+    return StrView_value(start, self->cursor - start);
+}
+
+StrView CharItr_take_until(CharItr *self, const CharSet *delimiters)
+{
+    const char *start = self->cursor;
+    do {
+        self->cursor += Kernel_find_any(self->cursor, self->sentinel - self->cursor, delimiters);
+    } while (self->cursor == self->sentinel && CharItr_refill(self, &start));
+    return StrView_value(start, self->cursor - start);
+}
+
+bool CharItr_refill(CharItr *self, const char **mark)
+{
+    if (self->stream == NULL) {
+        return false;
+    }
+    const char *keep = mark != NULL ? *mark : self->cursor;
+    size_t cursor_offset = self->cursor - keep;
+
+    size_t count = CharStream_fill(self->stream, keep);
+
+    // Whatever was kept now starts the buffer
+    const char *start = CharStream_start(self->stream);
+    self->cursor = start + cursor_offset;
+    self->sentinel = CharStream_end(self->stream);
+    if (mark != NULL) {
+        *mark = start;
+    }
+    return count > 0;
+}
@@ -0,0 +1,73 @@
+/* read(2) is POSIX, not C11 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "CharStream.h"
+
+CharStream CharStream_value(int fd, size_t chunk_size)
+{
+    CharStream stream = {
+        fd,
+        chunk_size,
+        Vec_value(chunk_size, sizeof(char)),
+        false,
+        0,
+        0
+    };
+    return stream;
+}
+
+void CharStream_drop(CharStream *self)
+{
+    Vec_drop(&self->buffer);
+}
+
+const char* CharStream_start(const CharStream *self)
+{
+    return (const char*) Vec_data(&self->buffer);
+}
+
+const char* CharStream_end(const CharStream *self)
+{
+    return CharStream_start(self) + Vec_length(&self->buffer);
+}
+
+size_t CharStream_fill(CharStream *self, const char *keep)
+{
+    char *start = (char*) Vec_data(&self->buffer);
+    size_t kept = CharStream_end(self) - keep;
+    memmove(start, keep, kept);
+    Vec_truncate(&self->buffer, kept);
+    self->fills++;
+
+    if (self->eof) {
+        return 0;
+    }
+
+    // Only a kept span as large as the whole buffer forces it to grow
+    if (Vec_capacity(&self->buffer) - kept == 0) {
+        Vec_reserve(&self->buffer, Vec_capacity(&self->buffer) * 2);
+    }
+
+    size_t space = Vec_capacity(&self->buffer) - kept;
+    ssize_t count;
+    do {
+        count = read(self->fd, Vec_spare(&self->buffer), space);
+    } while (count < 0 && errno == EINTR);
+
+    if (count <= 0) {
+        self->eof = true;
+        self->error = count < 0 ? errno : 0;
+        return 0;
+    }
+    Vec_set_length(&self->buffer, kept + count);
+    return count;
+}
+
+int CharStream_error(const CharStream *self)
+{
+    return self->error;
+}
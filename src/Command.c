@@ -0,0 +1,106 @@
+#include "Guards.h"
+#include "TypedVec.h"
+
+#include "Command.h"
+
+#define INITIAL_CHARS 64
+#define INITIAL_ARGC 4
+
+typedef char *CharPtr;
+VEC_DEFINE(CharPtr, ArgVec)
+
+static void _rebase(Command *self, const char *previous);
+
+Command Command_value(void)
+{
+    Command command = {
+        Vec_value(INITIAL_CHARS, sizeof(char)),
+        Vec_value(INITIAL_ARGC + 1, sizeof(CharPtr)),
+        Vec_inline(sizeof(AtomRef))
+    };
+    ArgVec_append(&command.argv, NULL);
+    return command;
+}
+
+void Command_drop(Command *self)
+{
+    Vec_drop(&self->chars);
+    Vec_drop(&self->argv);
+    Vec_drop(&self->atoms);
+}
+
+void Command_clear(Command *self)
+{
+    Vec_truncate(&self->chars, 0);
+    Vec_truncate(&self->argv, 1);
+    *ArgVec_at_unchecked(&self->argv, 0) = NULL;
+    Vec_truncate(&self->atoms, 0);
+}
+
+void Command_push(Command *self, const char *bytes, size_t length, const Atom *atom)
+{
+    const char *previous = (const char*) Vec_data(&self->chars);
+    size_t offset = Vec_length(&self->chars);
+    Vec_extend(&self->chars, bytes, length);
+    char terminator = '\0';
+    Vec_push(&self->chars, &terminator);
+    _rebase(self, previous);
+
+    // The word's pointer replaces the NULL, and a new NULL follows it
+    size_t argc = Command_length(self);
+    *ArgVec_at_unchecked(&self->argv, argc) = (char*) Vec_data(&self->chars) + offset;
+    ArgVec_append(&self->argv, NULL);
+
+    if (atom != NULL) {
+        AtomVec_append(&self->atoms, atom);
+    }
+}
+
+size_t Command_capacity(const Command *self)
+{
+    return Vec_capacity(&self->chars) * sizeof(char) +
+        Vec_capacity(&self->argv) * sizeof(CharPtr) +
+        Vec_capacity(&self->atoms) * sizeof(AtomRef);
+}
+
+size_t Command_length(const Command *self)
+{
+    return Vec_length(&self->argv) - 1;
+}
+
+const char* Command_word(const Command *self, size_t index)
+{
+    if (index >= Command_length(self)) {
+        OOB_PANIC(__FILE__, __LINE__);
+    }
+    return *ArgVec_at_unchecked(&self->argv, index);
+}
+
+const Atom* Command_atom(const Command *self, size_t index)
+{
+    if (index >= Command_length(self)) {
+        OOB_PANIC(__FILE__, __LINE__);
+    }
+    return index < Vec_length(&self->atoms) ? AtomVec_load(&self->atoms, index) : NULL;
+}
+
+char* const* Command_argv(const Command *self)
+{
+    return (char* const*) Vec_data(&self->argv);
+}
+
+/*
+ * Point argv back into chars after the buffer moved from `previous`.
+ */
+static void _rebase(Command *self, const char *previous)
+{
+    char *current = (char*) Vec_data(&self->chars);
+    if (current == previous) {
+        return;
+    }
+    size_t argc = Command_length(self);
+    for (size_t i = 0; i < argc; ++i) {
+        CharPtr *arg = ArgVec_at_unchecked(&self->argv, i);
+        *arg = current + (*arg - previous);
+    }
+}
@@ -79,16 +79,8 @@ static int exec_command(Node *node, Context *ctx)
 			close(ctx->fd_close);
 		}
 
-		StrVec *words = &node->data.command;
-		size_t argc = StrVec_length(words);
-		char *argv[argc + 1];
-		argv[argc] = NULL; // END OF ARGUMENTS
-
-		for (size_t i = 0; i < argc; ++i) {
-			Str *word = StrVec_ref(words, i);
-			argv[i] = Str_ref(word, 0);
-		}
-
+		// The parser packed argv already; nothing to build in the child
+		char* const* argv = Command_argv(&node->data.command);
 		execvp(argv[0], argv);
 	}	
 	return 1; // One child was spawned
@@ -1,6 +1,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "Guards.h"
+
 void OOM_GUARD(void *ptr, char *file, int number)
 {
     if (ptr == NULL) {
@@ -8,3 +10,9 @@ void OOM_GUARD(void *ptr, char *file, int number)
         exit(EXIT_FAILURE);
     }
 }
+
+void OOB_PANIC(const char *file, int number)
+{
+    fprintf(stderr, "%s:%d - Out of Bounds", file, number);
+    exit(EXIT_FAILURE);
+}
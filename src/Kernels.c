@@ -0,0 +1,459 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "Guards.h"
+#include "Kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KERNELS_X86
+#include <immintrin.h>
+#endif
+
+/* One implementation of every kernel */
+typedef struct Kernels {
+    KernelLevel level;
+    size_t (*length)(const char *cstr);
+    size_t (*find_any)(const char *bytes, size_t length, const CharSet *set);
+    size_t (*skip_while)(const char *bytes, size_t length, const CharSet *set);
+    bool (*equals)(const void *a, const void *b, size_t length);
+    void (*classify)(const char *bytes, size_t length, const CharSet *set, uint64_t *bits);
+} Kernels;
+
+static bool _is_member(const CharSet *set, char c);
+static KernelLevel _supported_level(void);
+static void _select_kernels(void) __attribute__((constructor));
+
+/* Scalar */
+
+static size_t _length_scalar(const char *cstr)
+{
+    const char *cursor = cstr;
+    while (*cursor != '\0') {
+        cursor++;
+    }
+    return cursor - cstr;
+}
+
+static size_t _find_any_scalar(const char *bytes, size_t length, const CharSet *set)
+{
+    size_t i = 0;
+    while (i < length && !_is_member(set, bytes[i])) {
+        i++;
+    }
+    return i;
+}
+
+static size_t _skip_while_scalar(const char *bytes, size_t length, const CharSet *set)
+{
+    size_t i = 0;
+    while (i < length && _is_member(set, bytes[i])) {
+        i++;
+    }
+    return i;
+}
+
+// memcmp is already vectorized by the C library, and beat our own loops
+static bool _equals_scalar(const void *a, const void *b, size_t length)
+{
+    return memcmp(a, b, length) == 0;
+}
+
+static void _classify_scalar(const char *bytes, size_t length, const CharSet *set, uint64_t *bits)
+{
+    for (size_t block = 0; block * 64 < length; ++block) {
+        bits[block] = 0;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        if (_is_member(set, bytes[i])) {
+            bits[i / 64] |= (uint64_t) 1 << (i % 64);
+        }
+    }
+}
+
+static const Kernels SCALAR_KERNELS = {
+    KERNEL_SCALAR,
+    _length_scalar,
+    _find_any_scalar,
+    _skip_while_scalar,
+    _equals_scalar,
+    _classify_scalar
+};
+
+#ifdef KERNELS_X86
+
+/*
+ * Vector kernels. Each block of input is compared against every member
+ * of the set, the comparisons are OR'd together, and movemask turns the
+ * result into one bit per byte so the first hit is a count of trailing
+ * zeros. The bytes left over after the last whole block never cause a
+ * read past the input. An input of at least one block loads the final
+ * block so that it ends with the input, overlapping bytes already
+ * scanned. A shorter input is copied into a zeroed block first.
+ *
+ * The length kernels cannot know where the string ends, so they only
+ * issue aligned loads. An aligned block never straddles a page
+ * boundary, so reading the whole block containing the terminator cannot
+ * fault. That read is still past the end of the string's object, so
+ * these two are exempt from AddressSanitizer, and valgrind.supp
+ * silences them for `make leak-check`.
+ */
+
+/* SSE2 */
+
+__attribute__((target("sse2")))
+static __m128i _hits_sse2(__m128i block, const __m128i *needles, size_t count)
+{
+    __m128i hits = _mm_setzero_si128();
+    for (size_t i = 0; i < count; ++i) {
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[i]));
+    }
+    return hits;
+}
+
+/*
+ * Hits of the bytes from `i` to `length`, fewer than a block, in the low
+ * bits of the result. Higher bits are garbage for the caller to mask.
+ */
+__attribute__((target("sse2")))
+static unsigned _tail_hits_sse2(const char *bytes, size_t i, size_t length, const __m128i *needles, size_t count)
+{
+    if (length >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*) (bytes + length - 16));
+        return (unsigned) _mm_movemask_epi8(_hits_sse2(block, needles, count)) >> (16 - (length - i));
+    }
+    char tail[16] = { 0 };
+    memcpy(tail, bytes + i, length - i);
+    __m128i block = _mm_loadu_si128((const __m128i*) tail);
+    return _mm_movemask_epi8(_hits_sse2(block, needles, count));
+}
+
+__attribute__((target("sse2"), no_sanitize_address))
+static size_t _length_sse2(const char *cstr)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t offset = (uintptr_t) cstr & 15;
+    const char *block = cstr - offset;
+
+    // Discard matches in the bytes of the first block preceding cstr
+    unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*) block), zero));
+    mask >>= offset;
+    if (mask != 0) {
+        return __builtin_ctz(mask);
+    }
+
+    for (;;) {
+        block += 16;
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*) block), zero));
+        if (mask != 0) {
+            return (block - cstr) + __builtin_ctz(mask);
+        }
+    }
+}
+
+__attribute__((target("sse2")))
+static size_t _find_any_sse2(const char *bytes, size_t length, const CharSet *set)
+{
+    __m128i needles[CHAR_SET_MAX];
+    for (size_t i = 0; i < set->count; ++i) {
+        needles[i] = _mm_set1_epi8(set->chars[i]);
+    }
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*) (bytes + i));
+        unsigned mask = _mm_movemask_epi8(_hits_sse2(block, needles, set->count));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    if (i < length) {
+        unsigned mask = _tail_hits_sse2(bytes, i, length, needles, set->count);
+        mask &= ((uint32_t) 1 << (length - i)) - 1;
+        return mask != 0 ? i + __builtin_ctz(mask) : length;
+    }
+    return length;
+}
+
+__attribute__((target("sse2")))
+static size_t _skip_while_sse2(const char *bytes, size_t length, const CharSet *set)
+{
+    __m128i needles[CHAR_SET_MAX];
+    for (size_t i = 0; i < set->count; ++i) {
+        needles[i] = _mm_set1_epi8(set->chars[i]);
+    }
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*) (bytes + i));
+        unsigned mask = ~_mm_movemask_epi8(_hits_sse2(block, needles, set->count)) & 0xFFFF;
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    if (i < length) {
+        unsigned mask = ~_tail_hits_sse2(bytes, i, length, needles, set->count);
+        mask &= ((uint32_t) 1 << (length - i)) - 1;
+        return mask != 0 ? i + __builtin_ctz(mask) : length;
+    }
+    return length;
+}
+
+__attribute__((target("sse2")))
+static void _classify_sse2(const char *bytes, size_t length, const CharSet *set, uint64_t *bits)
+{
+    __m128i needles[CHAR_SET_MAX];
+    for (size_t i = 0; i < set->count; ++i) {
+        needles[i] = _mm_set1_epi8(set->chars[i]);
+    }
+
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        uint64_t mask = 0;
+        for (size_t lane = 0; lane < 4; ++lane) {
+            __m128i block = _mm_loadu_si128((const __m128i*) (bytes + i + lane * 16));
+            uint64_t hits = (uint16_t) _mm_movemask_epi8(_hits_sse2(block, needles, set->count));
+            mask |= hits << (lane * 16);
+        }
+        bits[i / 64] = mask;
+    }
+    if (i < length) {
+        _classify_scalar(bytes + i, length - i, set, bits + i / 64);
+    }
+}
+
+static const Kernels SSE2_KERNELS = {
+    KERNEL_SSE2,
+    _length_sse2,
+    _find_any_sse2,
+    _skip_while_sse2,
+    _equals_scalar,
+    _classify_sse2
+};
+
+/* AVX2 */
+
+__attribute__((target("avx2")))
+static __m256i _hits_avx2(__m256i block, const __m256i *needles, size_t count)
+{
+    __m256i hits = _mm256_setzero_si256();
+    for (size_t i = 0; i < count; ++i) {
+        hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needles[i]));
+    }
+    return hits;
+}
+
+__attribute__((target("avx2")))
+static uint32_t _tail_hits_avx2(const char *bytes, size_t i, size_t length, const __m256i *needles, size_t count)
+{
+    if (length >= 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*) (bytes + length - 32));
+        return (uint32_t) _mm256_movemask_epi8(_hits_avx2(block, needles, count)) >> (32 - (length - i));
+    }
+    char tail[32] = { 0 };
+    memcpy(tail, bytes + i, length - i);
+    __m256i block = _mm256_loadu_si256((const __m256i*) tail);
+    return _mm256_movemask_epi8(_hits_avx2(block, needles, count));
+}
+
+__attribute__((target("avx2"), no_sanitize_address))
+static size_t _length_avx2(const char *cstr)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    size_t offset = (uintptr_t) cstr & 31;
+    const char *block = cstr - offset;
+
+    // Discard matches in the bytes of the first block preceding cstr
+    uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i*) block), zero));
+    mask >>= offset;
+    if (mask != 0) {
+        return __builtin_ctz(mask);
+    }
+
+    for (;;) {
+        block += 32;
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i*) block), zero));
+        if (mask != 0) {
+            return (block - cstr) + __builtin_ctz(mask);
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static size_t _find_any_avx2(const char *bytes, size_t length, const CharSet *set)
+{
+    __m256i needles[CHAR_SET_MAX];
+    for (size_t i = 0; i < set->count; ++i) {
+        needles[i] = _mm256_set1_epi8(set->chars[i]);
+    }
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*) (bytes + i));
+        uint32_t mask = _mm256_movemask_epi8(_hits_avx2(block, needles, set->count));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    if (i < length) {
+        uint32_t mask = _tail_hits_avx2(bytes, i, length, needles, set->count);
+        mask &= ((uint32_t) 1 << (length - i)) - 1;
+        return mask != 0 ? i + __builtin_ctz(mask) : length;
+    }
+    return length;
+}
+
+__attribute__((target("avx2")))
+static size_t _skip_while_avx2(const char *bytes, size_t length, const CharSet *set)
+{
+    __m256i needles[CHAR_SET_MAX];
+    for (size_t i = 0; i < set->count; ++i) {
+        needles[i] = _mm256_set1_epi8(set->chars[i]);
+    }
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*) (bytes + i));
+        uint32_t mask = ~(uint32_t) _mm256_movemask_epi8(_hits_avx2(block, needles, set->count));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    if (i < length) {
+        uint32_t mask = ~_tail_hits_avx2(bytes, i, length, needles, set->count);
+        mask &= ((uint32_t) 1 << (length - i)) - 1;
+        return mask != 0 ? i + __builtin_ctz(mask) : length;
+    }
+    return length;
+}
+
+__attribute__((target("avx2")))
+static void _classify_avx2(const char *bytes, size_t length, const CharSet *set, uint64_t *bits)
+{
+    __m256i needles[CHAR_SET_MAX];
+    for (size_t i = 0; i < set->count; ++i) {
+        needles[i] = _mm256_set1_epi8(set->chars[i]);
+    }
+
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        __m256i low = _mm256_loadu_si256((const __m256i*) (bytes + i));
+        __m256i high = _mm256_loadu_si256((const __m256i*) (bytes + i + 32));
+        uint64_t low_hits = (uint32_t) _mm256_movemask_epi8(_hits_avx2(low, needles, set->count));
+        uint64_t high_hits = (uint32_t) _mm256_movemask_epi8(_hits_avx2(high, needles, set->count));
+        bits[i / 64] = low_hits | high_hits << 32;
+    }
+    if (i < length) {
+        _classify_scalar(bytes + i, length - i, set, bits + i / 64);
+    }
+}
+
+static const Kernels AVX2_KERNELS = {
+    KERNEL_AVX2,
+    _length_avx2,
+    _find_any_avx2,
+    _skip_while_avx2,
+    _equals_scalar,
+    _classify_avx2
+};
+
+#endif
+
+/* Dispatch */
+
+// Scalar until the startup constructor has inspected the CPU
+static const Kernels *_kernels = &SCALAR_KERNELS;
+
+static void _select_kernels(void)
+{
+    Kernel_set_level(KERNEL_AVX2);
+}
+
+static KernelLevel _supported_level(void)
+{
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return KERNEL_AVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        return KERNEL_SSE2;
+    }
+#endif
+    return KERNEL_SCALAR;
+}
+
+KernelLevel Kernel_level(void)
+{
+    return _kernels->level;
+}
+
+KernelLevel Kernel_set_level(KernelLevel level)
+{
+    KernelLevel supported = _supported_level();
+    if (level > supported) {
+        level = supported;
+    }
+
+    switch (level) {
+#ifdef KERNELS_X86
+        case KERNEL_AVX2:
+            _kernels = &AVX2_KERNELS;
+            break;
+        case KERNEL_SSE2:
+            _kernels = &SSE2_KERNELS;
+            break;
+#endif
+        default:
+            _kernels = &SCALAR_KERNELS;
+            break;
+    }
+    return _kernels->level;
+}
+
+/* CharSet */
+
+CharSet CharSet_value(const char *chars, size_t count)
+{
+    if (count > CHAR_SET_MAX) {
+        OOB_PANIC(__FILE__, __LINE__);
+    }
+    CharSet set = { count, { 0 } };
+    memcpy(set.chars, chars, count);
+    return set;
+}
+
+static bool _is_member(const CharSet *set, char c)
+{
+    for (size_t i = 0; i < set->count; ++i) {
+        if (set->chars[i] == c) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Kernels */
+
+size_t Kernel_length(const char *cstr)
+{
+    return _kernels->length(cstr);
+}
+
+size_t Kernel_find_any(const char *bytes, size_t length, const CharSet *set)
+{
+    return _kernels->find_any(bytes, length, set);
+}
+
+size_t Kernel_skip_while(const char *bytes, size_t length, const CharSet *set)
+{
+    return _kernels->skip_while(bytes, length, set);
+}
+
+bool Kernel_equals(const void *a, const void *b, size_t length)
+{
+    return _kernels->equals(a, b, length);
+}
+
+void Kernel_classify(const char *bytes, size_t length, const CharSet *set, uint64_t *bits)
+{
+    _kernels->classify(bytes, length, set, bits);
+}
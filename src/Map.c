@@ -0,0 +1,384 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "Guards.h"
+#include "Str.h"
+
+#include "Map.h"
+
+/* Metadata byte values. Full slots hold 7 hash bits: 0b0xxxxxxx */
+#define CTRL_EMPTY   ((uint8_t) 0x80)
+#define CTRL_DELETED ((uint8_t) 0xFE)
+
+#define MIN_CAPACITY 8
+#define SLOT_ALIGN sizeof(uint64_t)
+
+/* A group of MAP_GROUP_WIDTH metadata bytes as one word */
+typedef uint64_t Group;
+
+#define LSBS ((Group) 0x0101010101010101ull)
+#define MSBS ((Group) 0x8080808080808080ull)
+
+static Group _group_load(const uint8_t *control);
+static Group _group_match(Group group, uint8_t h2);
+static Group _group_match_empty(Group group);
+static Group _group_match_empty_or_deleted(Group group);
+static size_t _group_first(Group mask);
+
+static size_t _h1(uint64_t hash);
+static uint8_t _h2(uint64_t hash);
+static void* _slot(const Map *self, size_t index);
+static void _set_control(Map *self, size_t index, uint8_t h2);
+static size_t _find_index(const Map *self, uint64_t hash, MapMatches matches, const void *probe);
+static size_t _find_insert_index(const Map *self, uint64_t hash);
+static void _rehash(Map *self, size_t capacity);
+static size_t _max_load(size_t capacity);
+
+static uint64_t _str_hash(const void *key);
+static bool _str_equals(const void *key, const void *other);
+static bool _str_matches(const void *key, const void *probe);
+static void _str_drop(void *key);
+
+#define NOT_FOUND ((size_t) -1)
+
+/* Constructor / Destructor */
+
+Map Map_value(size_t key_size, size_t value_size, MapHash hash, MapEquals equals, MapDropKey drop_key)
+{
+    size_t value_offset = (key_size + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+    size_t slot_size = (value_offset + value_size + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+    Map map = {
+        key_size,
+        value_size,
+        value_offset,
+        slot_size,
+        0,
+        0,
+        0,
+        NULL,
+        NULL,
+        hash,
+        equals,
+        drop_key,
+        Allocator_default()
+    };
+    return map;
+}
+
+Map Map_str_value(size_t value_size)
+{
+    return Map_value(sizeof(Str), value_size, _str_hash, _str_equals, _str_drop);
+}
+
+void Map_drop(Map *self)
+{
+    if (self->drop_key != NULL) {
+        size_t cursor = 0;
+        void *key;
+        void *value;
+        while (Map_next(self, &cursor, &key, &value)) {
+            self->drop_key(key);
+        }
+    }
+    if (self->capacity > 0) {
+        Allocator_free(self->allocator, self->control, self->capacity + MAP_GROUP_WIDTH);
+        Allocator_free(self->allocator, self->slots, self->capacity * self->slot_size);
+    }
+    self->control = NULL;
+    self->slots = NULL;
+    self->capacity = 0;
+    self->length = 0;
+    self->growth_left = 0;
+}
+
+/* Accessors */
+
+size_t Map_length(const Map *self)
+{
+    return self->length;
+}
+
+void* Map_get(const Map *self, const void *key)
+{
+    return Map_find(self, self->hash(key), (MapMatches) self->equals, key);
+}
+
+void* Map_find(const Map *self, uint64_t hash, MapMatches matches, const void *probe)
+{
+    size_t index = _find_index(self, hash, matches, probe);
+    if (index == NOT_FOUND) {
+        return NULL;
+    }
+    return (char*) _slot(self, index) + self->value_offset;
+}
+
+typedef struct StrProbe {
+    const char *bytes;
+    size_t length;
+} StrProbe;
+
+void* Map_get_str(const Map *self, const char *bytes, size_t length)
+{
+    StrProbe probe = { bytes, length };
+    return Map_find(self, Map_hash_bytes(bytes, length), _str_matches, &probe);
+}
+
+/* Operations */
+
+void* Map_set(Map *self, const void *key, const void *value)
+{
+    uint64_t hash = self->hash(key);
+    size_t index = _find_index(self, hash, (MapMatches) self->equals, key);
+    if (index != NOT_FOUND) {
+        if (self->drop_key != NULL) {
+            self->drop_key((void*) key);
+        }
+    } else {
+        if (self->growth_left == 0) {
+            // Double when genuinely full, otherwise rehash in place to purge tombstones
+            size_t capacity = self->capacity == 0 ? MIN_CAPACITY : self->capacity;
+            if (self->length + 1 > _max_load(capacity) / 2) {
+                capacity *= 2;
+            }
+            _rehash(self, capacity);
+        }
+        index = _find_insert_index(self, hash);
+        if (self->control[index] == CTRL_EMPTY) {
+            self->growth_left--;
+        }
+        _set_control(self, index, _h2(hash));
+        memcpy(_slot(self, index), key, self->key_size);
+        self->length++;
+    }
+    void *slot_value = (char*) _slot(self, index) + self->value_offset;
+    memcpy(slot_value, value, self->value_size);
+    return slot_value;
+}
+
+bool Map_remove(Map *self, const void *key, void *value_out)
+{
+    size_t index = _find_index(self, self->hash(key), (MapMatches) self->equals, key);
+    if (index == NOT_FOUND) {
+        return false;
+    }
+    void *slot = _slot(self, index);
+    if (value_out != NULL) {
+        memcpy(value_out, (char*) slot + self->value_offset, self->value_size);
+    }
+    if (self->drop_key != NULL) {
+        self->drop_key(slot);
+    }
+    // A tombstone keeps later entries of the same probe sequence reachable
+    _set_control(self, index, CTRL_DELETED);
+    self->length--;
+    return true;
+}
+
+bool Map_next(const Map *self, size_t *cursor, void **key, void **value)
+{
+    while (*cursor < self->capacity) {
+        size_t index = (*cursor)++;
+        if ((self->control[index] & 0x80) == 0) {
+            void *slot = _slot(self, index);
+            *key = slot;
+            *value = (char*) slot + self->value_offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Hashing */
+
+static uint64_t _mix(uint64_t x)
+{
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ull;
+    x ^= x >> 32;
+    return x;
+}
+
+uint64_t Map_hash_bytes(const void *bytes, size_t length)
+{
+    const unsigned char *cursor = (const unsigned char*) bytes;
+    uint64_t hash = 0x9e3779b97f4a7c15ull ^ length;
+    while (length >= sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, cursor, sizeof(word));
+        hash = (hash ^ _mix(word)) * 0xbf58476d1ce4e5b9ull;
+        cursor += sizeof(word);
+        length -= sizeof(word);
+    }
+    if (length > 0) {
+        uint64_t word = 0;
+        memcpy(&word, cursor, length);
+        hash = (hash ^ _mix(word)) * 0xbf58476d1ce4e5b9ull;
+    }
+    return _mix(hash);
+}
+
+/* Helpers */
+
+static size_t _h1(uint64_t hash)
+{
+    return (size_t) (hash >> 7);
+}
+
+static uint8_t _h2(uint64_t hash)
+{
+    return (uint8_t) (hash & 0x7F);
+}
+
+static void* _slot(const Map *self, size_t index)
+{
+    return (char*) self->slots + index * self->slot_size;
+}
+
+static void _set_control(Map *self, size_t index, uint8_t h2)
+{
+    self->control[index] = h2;
+    // The first group is mirrored past the end so that groups starting
+    // near the end of the table can be loaded without wrapping
+    if (index < MAP_GROUP_WIDTH) {
+        self->control[self->capacity + index] = h2;
+    }
+}
+
+static size_t _max_load(size_t capacity)
+{
+    return capacity - capacity / 8;
+}
+
+/*
+ * Probe groups in triangular steps. Because capacity is a power of two,
+ * the sequence visits every group before repeating.
+ */
+static size_t _find_index(const Map *self, uint64_t hash, MapMatches matches, const void *probe)
+{
+    if (self->length == 0) {
+        return NOT_FOUND;
+    }
+    size_t mask = self->capacity - 1;
+    size_t position = _h1(hash) & mask;
+    uint8_t h2 = _h2(hash);
+    for (size_t step = MAP_GROUP_WIDTH; ; step += MAP_GROUP_WIDTH) {
+        Group group = _group_load(self->control + position);
+        for (Group match = _group_match(group, h2); match != 0; match &= match - 1) {
+            size_t index = (position + _group_first(match)) & mask;
+            if (matches(_slot(self, index), probe)) {
+                return index;
+            }
+        }
+        if (_group_match_empty(group) != 0) {
+            return NOT_FOUND;
+        }
+        if (step > self->capacity) {
+            return NOT_FOUND;
+        }
+        position = (position + step) & mask;
+    }
+}
+
+static size_t _find_insert_index(const Map *self, uint64_t hash)
+{
+    size_t mask = self->capacity - 1;
+    size_t position = _h1(hash) & mask;
+    for (size_t step = MAP_GROUP_WIDTH; ; step += MAP_GROUP_WIDTH) {
+        Group group = _group_load(self->control + position);
+        Group available = _group_match_empty_or_deleted(group);
+        if (available != 0) {
+            return (position + _group_first(available)) & mask;
+        }
+        position = (position + step) & mask;
+    }
+}
+
+static void _rehash(Map *self, size_t capacity)
+{
+    Map old = *self;
+
+    self->capacity = capacity;
+    self->control = Allocator_alloc(self->allocator, capacity + MAP_GROUP_WIDTH);
+    OOM_GUARD(self->control, __FILE__, __LINE__);
+    self->slots = Allocator_alloc(self->allocator, capacity * self->slot_size);
+    OOM_GUARD(self->slots, __FILE__, __LINE__);
+    memset(self->control, CTRL_EMPTY, capacity + MAP_GROUP_WIDTH);
+    self->growth_left = _max_load(capacity) - old.length;
+
+    size_t cursor = 0;
+    void *key;
+    void *value;
+    while (Map_next(&old, &cursor, &key, &value)) {
+        uint64_t hash = self->hash(key);
+        size_t index = _find_insert_index(self, hash);
+        _set_control(self, index, _h2(hash));
+        memcpy(_slot(self, index), key, self->slot_size);
+    }
+
+    if (old.capacity > 0) {
+        Allocator_free(old.allocator, old.control, old.capacity + MAP_GROUP_WIDTH);
+        Allocator_free(old.allocator, old.slots, old.capacity * old.slot_size);
+    }
+}
+
+/* Group operations over MAP_GROUP_WIDTH metadata bytes */
+
+static Group _group_load(const uint8_t *control)
+{
+    Group group;
+    memcpy(&group, control, sizeof(group));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    group = __builtin_bswap64(group);
+#endif
+    return group;
+}
+
+/* High bit set in each byte equal to h2. May report false positives in
+ * bytes following a true match, which key comparison filters out. */
+static Group _group_match(Group group, uint8_t h2)
+{
+    Group x = group ^ (LSBS * h2);
+    return (x - LSBS) & ~x & MSBS;
+}
+
+static Group _group_match_empty(Group group)
+{
+    return group & (~group << 6) & MSBS;
+}
+
+static Group _group_match_empty_or_deleted(Group group)
+{
+    return group & ~(group << 7) & MSBS;
+}
+
+static size_t _group_first(Group mask)
+{
+    return (size_t) __builtin_ctzll(mask) / 8;
+}
+
+/* Str keys */
+
+static uint64_t _str_hash(const void *key)
+{
+    const Str *str = (const Str*) key;
+    return Map_hash_bytes(Str_cstr(str), Str_length(str));
+}
+
+static bool _str_equals(const void *key, const void *other)
+{
+    return Vec_equals((const Str*) key, (const Str*) other);
+}
+
+static bool _str_matches(const void *key, const void *probe)
+{
+    const Str *str = (const Str*) key;
+    const StrProbe *bytes = (const StrProbe*) probe;
+    return Str_length(str) == bytes->length &&
+        memcmp(Str_cstr(str), bytes->bytes, bytes->length) == 0;
+}
+
+static void _str_drop(void *key)
+{
+    Str_drop((Str*) key);
+}
@@ -0,0 +1,64 @@
+/* mmap, madvise and friends are POSIX, not C11 */
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "MappedFile.h"
+
+bool MappedFile_open(const char *path, MappedFile *out)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool mapped = MappedFile_open_fd(fd, out);
+    // The mapping stays valid without the descriptor
+    int error = errno;
+    close(fd);
+    errno = error;
+    return mapped;
+}
+
+bool MappedFile_open_fd(int fd, MappedFile *out)
+{
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
+        return false;
+    }
+    // A pipe or FIFO reports a size of 0 however much it will deliver
+    if (!S_ISREG(info.st_mode)) {
+        errno = ENODEV;
+        return false;
+    }
+
+    // mmap refuses empty mappings, and an empty file needs none
+    out->bytes = "";
+    out->length = (size_t) info.st_size;
+    if (out->length > 0) {
+        void *pages = mmap(NULL, out->length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pages == MAP_FAILED) {
+            return false;
+        }
+        madvise(pages, out->length, MADV_SEQUENTIAL);
+        out->bytes = (const char*) pages;
+    }
+    return true;
+}
+
+void MappedFile_drop(MappedFile *self)
+{
+    if (self->length > 0) {
+        munmap((void*) self->bytes, self->length);
+    }
+    self->bytes = "";
+    self->length = 0;
+}
+
+CharItr CharItr_of_MappedFile(const MappedFile *file)
+{
+    return CharItr_value(file->bytes, file->length);
+}
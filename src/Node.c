@@ -1,29 +1,25 @@
 #include "Node.h"
 #include "Guards.h"
 
+static Node* _Node_alloc(NodeType type);
+
 Node* ErrorNode_new(const char *msg)
 {
-    Node *node = malloc(sizeof(Node));
-    OOM_GUARD(node, __FILE__, __LINE__);
-    node->type = ERROR_NODE;
+    Node *node = _Node_alloc(ERROR_NODE);
     node->data.error = msg;
     return node;
 }
 
-Node* CommandNode_new(StrVec words)
+Node* CommandNode_new(Command command)
 {
-    Node *node = malloc(sizeof(Node));
-    OOM_GUARD(node, __FILE__, __LINE__);
-    node->type = COMMAND_NODE;
-    node->data.command = words;
+    Node *node = _Node_alloc(COMMAND_NODE);
+    node->data.command = command;
     return node;
 }
 
 Node* PipeNode_new(Node *left, Node *right)
 {
-    Node *node = malloc(sizeof(Node));
-    OOM_GUARD(node, __FILE__, __LINE__);
-    node->type = PIPE_NODE;
+    Node *node = _Node_alloc(PIPE_NODE);
     node->data.pipe.left = left;
     node->data.pipe.right = right;
     return node;
@@ -31,19 +27,32 @@ Node* PipeNode_new(Node *left, Node *right)
 
 void* Node_drop(Node *self)
 {
-	// Any memory leak you see isn't from Node_drop
-	// See comment under Scanner_next
+	return Node_drop_with(self, Command_drop);
+}
+
+void* Node_drop_with(Node *self, void (*drop_command)(Command *command))
+{
 	switch (self->type) {
 		case ERROR_NODE:
 			break;
 		case COMMAND_NODE:
-			StrVec_drop(&(self->data.command));
+			drop_command(&(self->data.command));
 			break;
 		case PIPE_NODE:
-			Node_drop(self->data.pipe.left);
-			Node_drop(self->data.pipe.right);
+			Node_drop_with(self->data.pipe.left, drop_command);
+			Node_drop_with(self->data.pipe.right, drop_command);
 			break;
 	}
-	free(self);
+	Allocator_free(self->allocator, self, sizeof(Node));
 	return NULL;
 }
+
+static Node* _Node_alloc(NodeType type)
+{
+    const Allocator *allocator = Allocator_default();
+    Node *node = Allocator_alloc(allocator, sizeof(Node));
+    OOM_GUARD(node, __FILE__, __LINE__);
+    node->type = type;
+    node->allocator = allocator;
+    return node;
+}
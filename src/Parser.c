@@ -1,37 +1,128 @@
 #include "Parser.h"
 
-static Node* parse_command(Scanner *scanner);
+// Commands kept by parse_recycle for parse_command to refill
+#define RECYCLED_MAX 16
+
+static Command recycled[RECYCLED_MAX];
+static size_t recycled_count = 0;
+
+// Tokens a Scanner hands the parser per Scanner_fill
+#define PARSE_BATCH 64
+
+/*
+ * The parser reads Tokens by index from an array: either a caller's, or
+ * a batch that a Scanner refills whenever the parser has used it up.
+ */
+typedef struct Tokens {
+	Scanner *scanner;	/* refills batch, or NULL for a caller's array */
+	const Token *tokens;
+	size_t count;
+	size_t index;
+	Token batch[PARSE_BATCH];
+} Tokens;
+
+static Node* parse_line(Tokens *tokens);
+static Node* parse_command(Tokens *tokens);
+static const Token* peek_token(Tokens *tokens);
+static void recycle_command(Command *command);
 
 Node* parse(Scanner *scanner)
 {
-	if (!Scanner_has_next(scanner)) {
-		return ErrorNode_new("End of text stream");
+	Tokens tokens;
+	tokens.scanner = scanner;
+	tokens.tokens = tokens.batch;
+	tokens.count = 0;
+	tokens.index = 0;
+	return parse_line(&tokens);
+}
+
+Node* parse_tokens(const Token *array, size_t count)
+{
+	Tokens tokens;
+	tokens.scanner = NULL;
+	tokens.tokens = array;
+	tokens.count = count;
+	tokens.index = 0;
+	return parse_line(&tokens);
+}
+
+Node* parse_view(const StrView *input)
+{
+	Scanner scanner = Scanner_value(CharItr_of_StrView(input));
+	return parse(&scanner);
+}
+
+void parse_recycle(Node *tree)
+{
+	Node_drop_with(tree, recycle_command);
+}
+
+void parse_release(void)
+{
+	while (recycled_count > 0) {
+		Command_drop(&recycled[--recycled_count]);
 	}
+}
 
-	Token next = Scanner_peek(scanner);
-	if (next.type != WORD_TOKEN) {
+static Node* parse_line(Tokens *tokens)
+{
+	const Token *next = peek_token(tokens);
+	if (next == NULL) {
+		return ErrorNode_new("End of text stream");
+	}
+	if (next->type == PIPE_TOKEN) {
 		return ErrorNode_new("Expected a word token");
 	}
 
-	Node *left = parse_command(scanner);
-	if (!Scanner_has_next(scanner) || 
-			Scanner_peek(scanner).type != PIPE_TOKEN) {
+	Node *left = parse_command(tokens);
+	if (peek_token(tokens) == NULL) {
 		return left;
 	}
-	
-	next = Scanner_next(scanner);
-	Str_drop(&(next.lexeme));
-	
-	Node *right = parse(scanner);
+	tokens->index++;
+
+	Node *right = parse_line(tokens);
 	return PipeNode_new(left, right);
 }
 
-static Node* parse_command(Scanner *scanner)
+static Node* parse_command(Tokens *tokens)
+{
+	// Words are packed straight into the Command's argv-ready buffers
+	Command command = recycled_count > 0 ? recycled[--recycled_count] : Command_value();
+	// Operators that cannot be executed yet are passed on as words, as
+	// they were before the scanner recognized them
+	const Token *word;
+	while ((word = peek_token(tokens)) != NULL && word->type != PIPE_TOKEN) {
+		if (word->quoted) {
+			Str unquoted = Token_to_Str(word);
+			Command_push(&command, Str_cstr(&unquoted), Str_length(&unquoted), NULL);
+			Str_drop(&unquoted);
+		} else {
+			Command_push(&command, word->start, word->length, Token_atom(word));
+		}
+		tokens->index++;
+	}
+	return CommandNode_new(command);
+}
+
+// The next Token of the line, or NULL at its end
+static const Token* peek_token(Tokens *tokens)
+{
+	if (tokens->index == tokens->count && tokens->scanner != NULL) {
+		tokens->count = Scanner_fill(tokens->scanner, tokens->batch, PARSE_BATCH);
+		tokens->index = 0;
+	}
+	if (tokens->index == tokens->count || tokens->tokens[tokens->index].type == END_TOKEN) {
+		return NULL;
+	}
+	return &tokens->tokens[tokens->index];
+}
+
+static void recycle_command(Command *command)
 {
-	StrVec words = StrVec_value(1);
-	while (Scanner_has_next(scanner) && 
-			Scanner_peek(scanner).type == WORD_TOKEN) {
-		StrVec_push(&words, Scanner_next(scanner).lexeme);
+	if (recycled_count == RECYCLED_MAX || Command_capacity(command) > PARSE_HIGH_WATER) {
+		Command_drop(command);
+		return;
 	}
-	return CommandNode_new(words);
+	Command_clear(command);
+	recycled[recycled_count++] = *command;
 }
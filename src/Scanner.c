@@ -1,97 +1,527 @@
 #include <stdio.h>
+#include <stdint.h>
 #include <ctype.h>
 
+#include "CharStream.h"
+#include "Kernels.h"
 #include "Scanner.h"
 
+// In-memory inputs at least this long are scanned through a StructuralIndex
+#define INDEXED_MIN_LENGTH 1024
+
+static const CharSet NEWLINE = { 1, "\n" };
+
+static Scanner _Scanner_init(CharItr char_itr, bool interning);
+static bool indexes(const CharItr *char_itr);
+static bool line_buffered(Scanner *self);
 static void update_next_token(Scanner *self);
+static void scan_taken(Scanner *self);
 
 Scanner Scanner_value(CharItr char_itr)
+{
+    return _Scanner_init(char_itr, false);
+}
+
+Scanner Scanner_interning(CharItr char_itr)
+{
+    return _Scanner_init(char_itr, true);
+}
+
+static Scanner _Scanner_init(CharItr char_itr, bool interning)
 {
     Token next = {
+        NULL,
+        0,
         END_TOKEN,
-        Str_from("")
+        false,
+        false
     };
 
     Scanner itr = {
         char_itr,
-        next
+        next,
+        false,
+        interning,
+        indexes(&char_itr),
+        StructuralIndex_value(),
+        NULL,
+        0
     };
 
-    Str_drop(&(next.lexeme));
     update_next_token(&itr);
 
     return itr;
 }
 
-bool Scanner_has_next(const Scanner *self)
+void Scanner_reset(Scanner *self, CharItr char_itr)
+{
+    self->char_itr = char_itr;
+    self->taken = false;
+    self->indexed = indexes(&char_itr);
+    // The index window is rebuilt in place on first use
+    self->index.base = NULL;
+    self->newline = NULL;
+    update_next_token(self);
+}
+
+void Scanner_drop(Scanner *self)
+{
+    // Nothing is heap allocated; leave no input behind to be scanned
+    Scanner_reset(self, CharItr_value("", 0));
+}
+
+static bool indexes(const CharItr *char_itr)
 {
+    return char_itr->stream == NULL && char_itr->sentinel - char_itr->cursor >= INDEXED_MIN_LENGTH;
+}
+
+bool Scanner_has_next(Scanner *self)
+{
+    scan_taken(self);
     return self->next.type != END_TOKEN;
 }
 
-Token Scanner_peek(const Scanner *self)
+Token Scanner_peek(Scanner *self)
 {
+    scan_taken(self);
     return self->next;
 }
 
 Token Scanner_next(Scanner *self)
 {
-    Token next = self->next;
-    update_next_token(self);
-    /* Note: Because self->next always holds the next peekable token value
-     * (even if it's a repeating end token) which contains heap memory
-     * in its Str, a Scanner will always produce a memory leak because
-     * it has no drop function to free the heap memory in self->next
-     * Given the assignment instructions, I couldn't think of a workaround
-     */
-    return next;
+    scan_taken(self);
+    self->taken = true;
+    return self->next;
 }
 
+size_t Scanner_fill(Scanner *self, Token *out, size_t max)
+{
+	size_t count = 0;
+	while (count < max) {
+		scan_taken(self);
+		if (self->next.type == END_TOKEN) {
+			break;
+		}
+		out[count++] = self->next;
+		self->taken = true;
+
+		// Without the line's newline in the buffer, the next scan may refill
+		if (count == 1 && self->char_itr.stream != NULL && !line_buffered(self)) {
+			break;
+		}
+	}
+	return count;
+}
+
+/*
+ * Whether the newline ending a streamed line is in the buffer. The
+ * buffer is searched once per fill and the answer kept until a fill
+ * moves the chars or the cursor passes the newline, so a line longer
+ * than the buffer is not searched again for every Token.
+ */
+static bool line_buffered(Scanner *self)
+{
+	CharItr *itr = &(self->char_itr);
+	if (self->newline == NULL || self->newline_fills != itr->stream->fills ||
+			self->newline < itr->cursor) {
+		self->newline = itr->cursor +
+			Kernel_find_any(itr->cursor, itr->sentinel - itr->cursor, &NEWLINE);
+		self->newline_fills = itr->stream->fills;
+	}
+	return self->newline != itr->sentinel;
+}
+
+bool Scanner_next_line(Scanner *self)
+{
+	// Discard whatever the current line has left
+	while (Scanner_has_next(self)) {
+		Scanner_next(self);
+	}
+
+	// An END_TOKEN for a '\0' leaves the rest of its line unscanned
+	CharItr *itr = &(self->char_itr);
+	CharItr_take_until(itr, &NEWLINE);
+	if (!CharItr_has_next(itr)) {
+		return false;
+	}
+	CharItr_next_unchecked(itr);
+	if (!CharItr_has_next(itr)) {
+		return false;
+	}
+
+	update_next_token(self);
+	return true;
+}
+
+StrView Token_view(const Token *self)
+{
+    return StrView_value(self->start, self->length);
+}
+
+Str Token_to_Str(const Token *self)
+{
+    if (!self->quoted) {
+        return Str_inline_from_n(self->start, self->length);
+    }
+
+    // Copy the chars between the quoting, run by run
+    Str word = Str_inline();
+    const char *cursor = self->start;
+    const char *end = cursor + self->length;
+    while (cursor < end) {
+        const char *run = cursor;
+        switch (*cursor) {
+            case '\'':
+                while (++cursor < end && *cursor != '\'') {
+                }
+                Str_append_n(&word, run + 1, cursor - run - 1);
+                cursor++;
+                break;
+            case '"':
+                while (++cursor < end && *cursor != '"') {
+                    // Inside "", a \ only escapes the chars it could end or begin
+                    if (*cursor == '\\' && cursor + 1 < end &&
+                            (cursor[1] == '"' || cursor[1] == '\\' ||
+                             cursor[1] == '$' || cursor[1] == '`')) {
+                        cursor++;
+                    }
+                    Str_append_n(&word, cursor, 1);
+                }
+                cursor++;
+                break;
+            case '\\':
+                // A \ ending the line stands for itself
+                cursor += cursor + 1 < end ? 1 : 0;
+                Str_append_n(&word, cursor++, 1);
+                break;
+            default:
+                while (++cursor < end && *cursor != '\'' && *cursor != '"' && *cursor != '\\') {
+                }
+                Str_append_n(&word, run, cursor - run);
+                break;
+        }
+    }
+    return word;
+}
+
+const Atom* Token_atom(const Token *self)
+{
+    return self->interned ? Atom_of_cstr(self->start) : NULL;
+}
+
+static void scan_taken(Scanner *self)
+{
+	// Scanning waits until here so that a streamed Token handed out by
+	// Scanner_next keeps its chars until the caller comes back
+	if (self->taken) {
+		self->taken = false;
+		update_next_token(self);
+	}
+}
+
+/*
+ * Tokens are recognized by a table-driven state machine. Each input
+ * char is mapped to a class by CHAR_CLASS, and TRANSITIONS gives the
+ * next state for the current state and class. The machine runs until
+ * it has no transition (STATE_STOP) and the token is the longest prefix
+ * that ended in an accepting state (maximal munch), so `||` is one OR
+ * token rather than two pipes, and `2>&1` one DUP token rather than a
+ * word and three operators. New operators are new rows, not new branches.
+ *
+ * Quotes and backslashes are rows too. A word that reaches one moves
+ * into the quoted states, which accept as QUOTED_WORD, so plain words
+ * pay nothing for quoting. Quoted words keep their chars as written in
+ * the input, and Token_to_Str removes the quoting. A quote left open
+ * runs to the end of the line.
+ */
+
+typedef enum CharClass {
+	CLASS_WORD = 0,	/* anything not listed below */
+	CLASS_DIGIT,
+	CLASS_SPACE,
+	CLASS_NEWLINE,
+	CLASS_END,	/* '\0', and 0xFF, which is what a char holding EOF reads as */
+	CLASS_PIPE,
+	CLASS_AMP,
+	CLASS_GT,
+	CLASS_LT,
+	CLASS_QUOTE,	/* ' */
+	CLASS_DQUOTE,	/* " */
+	CLASS_ESCAPE,	/* \ */
+	CLASS_COUNT
+} CharClass;
+
+static const uint8_t CHAR_CLASS[256] = {
+	['0'] = CLASS_DIGIT, ['1'] = CLASS_DIGIT, ['2'] = CLASS_DIGIT, ['3'] = CLASS_DIGIT,
+	['4'] = CLASS_DIGIT, ['5'] = CLASS_DIGIT, ['6'] = CLASS_DIGIT, ['7'] = CLASS_DIGIT,
+	['8'] = CLASS_DIGIT, ['9'] = CLASS_DIGIT,
+	[' '] = CLASS_SPACE, ['\t'] = CLASS_SPACE,
+	['\n'] = CLASS_NEWLINE,
+	['\0'] = CLASS_END, [0xFF] = CLASS_END,
+	['|'] = CLASS_PIPE,
+	['&'] = CLASS_AMP,
+	['>'] = CLASS_GT,
+	['<'] = CLASS_LT,
+	['\''] = CLASS_QUOTE,
+	['"'] = CLASS_DQUOTE,
+	['\\'] = CLASS_ESCAPE,
+};
+
+typedef enum ScanState {
+	STATE_STOP = 0,
+	STATE_START,
+	STATE_WORD,
+	STATE_DIGITS,		/* a word of digits, so far, which may be the fd of a DUP */
+	STATE_DIGITS_GT,	/* 2> */
+	STATE_DIGITS_GT_AMP,	/* 2>& */
+	STATE_DUP,		/* 2>&1 */
+	STATE_PIPE,
+	STATE_OR,
+	STATE_AMP,
+	STATE_AND,
+	STATE_GT,
+	STATE_APPEND,
+	STATE_LT,
+	STATE_QUOTED_WORD,	/* a word after its quotes or escapes */
+	STATE_SQUOTE,		/* inside '' */
+	STATE_DQUOTE,		/* inside "" */
+	STATE_DQUOTE_ESCAPE,	/* a \ inside "" */
+	STATE_ESCAPE,		/* a \ outside quotes */
+	STATE_COUNT
+} ScanState;
+
+// The classes with no meaning inside quotes. Quoted rows list the quoting
+// classes themselves, and leave out the ends of a line, which no quoting
+// reaches past.
+#define INSIDE_QUOTES(state) \
+	[CLASS_WORD] = state, [CLASS_DIGIT] = state, [CLASS_SPACE] = state, \
+	[CLASS_PIPE] = state, [CLASS_AMP] = state, [CLASS_GT] = state, \
+	[CLASS_LT] = state
+
+// The classes that move a word into the quoted states
+#define QUOTING \
+	[CLASS_QUOTE] = STATE_SQUOTE, [CLASS_DQUOTE] = STATE_DQUOTE, \
+	[CLASS_ESCAPE] = STATE_ESCAPE
+
+static const uint8_t TRANSITIONS[STATE_COUNT][CLASS_COUNT] = {
+	[STATE_START] = {
+		[CLASS_WORD] = STATE_WORD, [CLASS_DIGIT] = STATE_DIGITS,
+		[CLASS_PIPE] = STATE_PIPE, [CLASS_AMP] = STATE_AMP,
+		[CLASS_GT] = STATE_GT, [CLASS_LT] = STATE_LT,
+		QUOTING
+	},
+	[STATE_WORD] = { [CLASS_WORD] = STATE_WORD, [CLASS_DIGIT] = STATE_WORD, QUOTING },
+	[STATE_DIGITS] = {
+		[CLASS_WORD] = STATE_WORD, [CLASS_DIGIT] = STATE_DIGITS,
+		[CLASS_GT] = STATE_DIGITS_GT, QUOTING
+	},
+	[STATE_DIGITS_GT] = { [CLASS_AMP] = STATE_DIGITS_GT_AMP },
+	[STATE_DIGITS_GT_AMP] = { [CLASS_DIGIT] = STATE_DUP },
+	[STATE_DUP] = { [CLASS_DIGIT] = STATE_DUP },
+	[STATE_PIPE] = { [CLASS_PIPE] = STATE_OR },
+	[STATE_AMP] = { [CLASS_AMP] = STATE_AND },
+	[STATE_GT] = { [CLASS_GT] = STATE_APPEND },
+	[STATE_QUOTED_WORD] = {
+		[CLASS_WORD] = STATE_QUOTED_WORD, [CLASS_DIGIT] = STATE_QUOTED_WORD, QUOTING
+	},
+	[STATE_SQUOTE] = {
+		INSIDE_QUOTES(STATE_SQUOTE),
+		[CLASS_QUOTE] = STATE_QUOTED_WORD, [CLASS_DQUOTE] = STATE_SQUOTE,
+		[CLASS_ESCAPE] = STATE_SQUOTE
+	},
+	[STATE_DQUOTE] = {
+		INSIDE_QUOTES(STATE_DQUOTE),
+		[CLASS_QUOTE] = STATE_DQUOTE, [CLASS_DQUOTE] = STATE_QUOTED_WORD,
+		[CLASS_ESCAPE] = STATE_DQUOTE_ESCAPE
+	},
+	[STATE_DQUOTE_ESCAPE] = {
+		INSIDE_QUOTES(STATE_DQUOTE),
+		[CLASS_QUOTE] = STATE_DQUOTE, [CLASS_DQUOTE] = STATE_DQUOTE,
+		[CLASS_ESCAPE] = STATE_DQUOTE
+	},
+	[STATE_ESCAPE] = {
+		INSIDE_QUOTES(STATE_QUOTED_WORD),
+		[CLASS_QUOTE] = STATE_QUOTED_WORD, [CLASS_DQUOTE] = STATE_QUOTED_WORD,
+		[CLASS_ESCAPE] = STATE_QUOTED_WORD
+	},
+};
+
+// The token a state accepts, or REJECT if a token cannot end there
+#define REJECT (-2)
+// A WORD_TOKEN whose lexeme has quoting to remove
+#define QUOTED_WORD (-3)
+
+static const int8_t ACCEPTS[STATE_COUNT] = {
+	[STATE_STOP] = REJECT,
+	[STATE_START] = REJECT,
+	[STATE_WORD] = WORD_TOKEN,
+	[STATE_DIGITS] = WORD_TOKEN,
+	[STATE_DIGITS_GT] = REJECT,
+	[STATE_DIGITS_GT_AMP] = REJECT,
+	[STATE_DUP] = DUP_TOKEN,
+	[STATE_PIPE] = PIPE_TOKEN,
+	[STATE_OR] = OR_TOKEN,
+	[STATE_AMP] = BACKGROUND_TOKEN,
+	[STATE_AND] = AND_TOKEN,
+	[STATE_GT] = REDIRECT_OUT_TOKEN,
+	[STATE_APPEND] = APPEND_TOKEN,
+	[STATE_LT] = REDIRECT_IN_TOKEN,
+	[STATE_QUOTED_WORD] = QUOTED_WORD,
+	[STATE_SQUOTE] = QUOTED_WORD,
+	[STATE_DQUOTE] = QUOTED_WORD,
+	[STATE_DQUOTE_ESCAPE] = QUOTED_WORD,
+	[STATE_ESCAPE] = QUOTED_WORD,
+};
+
+// Chars between tokens. A newline ends the line's tokens; see Scanner_next_line.
+static const CharSet SPACES = { 2, " \t" };
+// Every char whose class is neither CLASS_WORD nor CLASS_DIGIT
+static const CharSet WORD_ENDS = { 12, " \t\n|&><'\"\\\0\xff" };
+// Words this long have the rest of their chars skipped with a kernel.
+// Most words are shorter, and the state machine cuts them faster.
+#define LONG_WORD 16
+
+static void make_token(Token *out, int type, const char *start, size_t length);
+static void set_next(Scanner *self, int type, const char *start, size_t length);
 static void skip_spaces(CharItr *itr);
-static void take_pipe(Scanner *self);
+static bool take_indexed(Scanner *self);
 static void take_end(Scanner *self);
-static void take_word(Scanner *self);
+static void take_token(Scanner *self);
 
 static void update_next_token(Scanner *self)
 {
 	CharItr *itr = &(self->char_itr);
+	if (self->indexed && take_indexed(self)) {
+		return;
+	}
 	skip_spaces(itr);
 
 	if (!CharItr_has_next(itr)) {
-		self->next.type = END_TOKEN;
-    		self->next.lexeme = Str_from("");
+		set_next(self, END_TOKEN, itr->cursor, 0);
 		return;
 	}
 
-	switch (CharItr_peek(itr)) {
-		case '|':
-			take_pipe(self);
+	switch (CHAR_CLASS[(unsigned char) CharItr_peek_unchecked(itr)]) {
+		case CLASS_NEWLINE:
+			// Left unconsumed until the caller moves on to the next line
+			set_next(self, END_TOKEN, itr->cursor, 0);
 			break;
-		case '\0': case EOF: 
-			// Doubt this case would ever happen, but this is here just in case
-			// Also a char can't even equal an EOF because EOF is an int quantity 
+		case CLASS_END:
 			take_end(self);
 			break;
 		default:
-			take_word(self);
+			take_token(self);
 			break;
 	}
 }
 
-static void skip_spaces(CharItr *itr)
+// `type` is a TokenType, or QUOTED_WORD
+static void make_token(Token *out, int type, const char *start, size_t length)
+{
+	out->quoted = type == QUOTED_WORD;
+	out->type = out->quoted ? WORD_TOKEN : type;
+	out->interned = false;
+	out->start = start;
+	// Token.length is 32 bits to keep Tokens to 16 bytes
+	if (length > UINT32_MAX) {
+		fprintf(stderr, "%s:%d - Token longer than 4 GiB", __FILE__, __LINE__);
+		exit(EXIT_FAILURE);
+	}
+	out->length = (uint32_t) length;
+}
+
+static void set_next(Scanner *self, int type, const char *start, size_t length)
 {
-	char nextChar;
-	while (CharItr_has_next(itr) &&
-			((nextChar = CharItr_peek(itr)) == ' ' ||
-			 nextChar == '\t' || nextChar == '\n')) {
-		CharItr_next(itr);
+	Token *next = &(self->next);
+	make_token(next, type, start, length);
+	if (self->interning && next->type == WORD_TOKEN) {
+		// The Atom's chars outlive the input, so borrow those instead
+		const Atom *atom;
+		if (next->quoted) {
+			Str word = Token_to_Str(next);
+			atom = Atom_intern(Str_cstr(&word), Str_length(&word));
+			Str_drop(&word);
+		} else {
+			atom = Atom_intern(start, length);
+		}
+		next->start = Atom_cstr(atom);
+		next->length = atom->length;
+		next->quoted = false;
+		next->interned = true;
 	}
 }
 
-static void take_pipe(Scanner *self)
+static void skip_spaces(CharItr *itr)
 {
-	CharItr_next(&(self->char_itr));
-	self->next.type = PIPE_TOKEN;
-	self->next.lexeme = Str_from("|");
+	CharItr_skip_while(itr, &SPACES);
+}
+
+/*
+ * The second stage of the indexed path. Skips spaces and cuts a word by
+ * walking the StructuralIndex rather than the chars. Returns false,
+ * with the cursor at the next token or at the end of input, whenever
+ * the state machine has to decide: operators, end chars, quoting, words
+ * running past the window, and digit words that may begin a DUP.
+ */
+static bool take_indexed(Scanner *self)
+{
+	CharItr *itr = &(self->char_itr);
+	StructuralIndex *index = &(self->index);
+
+	for (;;) {
+		const char *window_end = index->base + index->length;
+		if (index->base == NULL || itr->cursor >= window_end) {
+			if (itr->cursor == itr->sentinel) {
+				return false;
+			}
+			StructuralIndex_build(index, itr->cursor, itr->sentinel - itr->cursor);
+			window_end = index->base + index->length;
+		}
+
+		// Entries before the cursor were consumed, and word ends at spaces start nothing
+		while (index->next < index->count &&
+				(index->base + index->offsets[index->next] < itr->cursor ||
+				 CHAR_CLASS[(unsigned char) index->base[index->offsets[index->next]]] == CLASS_SPACE)) {
+			index->next++;
+		}
+		// A token the state machine cut short of a word, as with the 1x of
+		// 2>&1x, leaves the cursor inside what the index saw as one word
+		uint8_t at_cursor = CHAR_CLASS[(unsigned char) *itr->cursor];
+		if ((at_cursor == CLASS_WORD || at_cursor == CLASS_DIGIT) &&
+				(index->next == index->count ||
+				 index->base + index->offsets[index->next] != itr->cursor)) {
+			return false;
+		}
+		if (index->next == index->count) {
+			// Only spaces remain in this window
+			itr->cursor = window_end;
+			continue;
+		}
+
+		const char *start = index->base + index->offsets[index->next];
+		itr->cursor = start;
+		uint8_t class = CHAR_CLASS[(unsigned char) *start];
+		if (class == CLASS_NEWLINE) {
+			// Left unconsumed until the caller moves on to the next line
+			set_next(self, END_TOKEN, start, 0);
+			return true;
+		}
+		if ((class != CLASS_WORD && class != CLASS_DIGIT) || index->next + 1 == index->count) {
+			return false;
+		}
+
+		const char *end = index->base + index->offsets[index->next + 1];
+		uint8_t end_class = CHAR_CLASS[(unsigned char) *end];
+		if (end_class == CLASS_GT || end_class == CLASS_QUOTE ||
+				end_class == CLASS_DQUOTE || end_class == CLASS_ESCAPE) {
+			return false;
+		}
+		index->next++;
+		itr->cursor = end;
+
+		set_next(self, WORD_TOKEN, start, end - start);
+		return true;
+	}
 }
 
 // This function doesn't really make sense if end tokens are meant to
@@ -99,26 +529,175 @@ static void take_pipe(Scanner *self)
 // case, this function is never called.
 static void take_end(Scanner *self)
 {
-	char nextChar = CharItr_next(&(self->char_itr));
-	Str nextLexeme = Str_value(1);
-	Str_set(&nextLexeme, 0, nextChar);
-	self->next.type = END_TOKEN;
-	self->next.lexeme = nextLexeme;
+	CharItr *itr = &(self->char_itr);
+	set_next(self, END_TOKEN, itr->cursor, 1);
+	CharItr_next_unchecked(itr);
 }
 
-static void take_word(Scanner *self)
+static void take_token(Scanner *self)
 {
-	char nextChar;
 	CharItr *itr = &(self->char_itr);
-	Str nextLexeme = Str_value(1);
+	const char *start = CharItr_cursor(itr);
+	uint8_t state = STATE_START;
+	int type = REJECT;
+	size_t accepted = 0;
 
-	while (CharItr_has_next(itr) && (nextChar = CharItr_peek(itr)) != ' ' && 
-			nextChar != '\t' && nextChar != '\n' && nextChar != '|' && 
-			nextChar != '\0' && nextChar != EOF) {
-		Str_set(&nextLexeme, Str_length(&nextLexeme), nextChar);
-		CharItr_next(itr);
+	for (;;) {
+		// A streaming CharItr may run out mid-token; refilling keeps it from start
+		if (itr->cursor == itr->sentinel && !CharItr_refill(itr, &start)) {
+			break;
+		}
+		state = TRANSITIONS[state][CHAR_CLASS[(unsigned char) *itr->cursor]];
+		if (state == STATE_STOP) {
+			break;
+		}
+		itr->cursor++;
+		if (state == STATE_WORD && (size_t) (itr->cursor - start) >= LONG_WORD) {
+			// A plain word stays in STATE_WORD to its end, so skip the rest at once
+			itr->cursor += Kernel_find_any(itr->cursor, itr->sentinel - itr->cursor, &WORD_ENDS);
+		}
+		if (ACCEPTS[state] != REJECT) {
+			type = ACCEPTS[state];
+			accepted = itr->cursor - start;
+		}
 	}
 
-	self->next.type = WORD_TOKEN;
-	self->next.lexeme = nextLexeme;
+	// Back up to the end of the longest token accepted. Every class
+	// leaving STATE_START accepts, so at least one char always is.
+	itr->cursor = start + accepted;
+
+	set_next(self, type, start, accepted);
+}
+
+/*
+ * PushScanner runs the same state machine, but keeps its state in the
+ * PushScanner between calls so that a token can straddle chunks. The
+ * chars of a straddling token are carried over, and when the machine
+ * backs up into carried chars (2>& followed by a non-digit), the chars
+ * after the accepted token are run through the machine again before
+ * the chunk is.
+ */
+
+PushScanner PushScanner_value(void)
+{
+	PushScanner scanner = {
+		CharItr_value("", 0),
+		false,
+		Str_value(0),
+		0,
+		0,
+		STATE_STOP,
+		REJECT,
+		0
+	};
+	return scanner;
+}
+
+void PushScanner_drop(PushScanner *self)
+{
+	Str_drop(&(self->carry));
+}
+
+void PushScanner_feed(PushScanner *self, const char *chunk, size_t length)
+{
+	self->chunk = CharItr_value(chunk, length);
+}
+
+void PushScanner_finish(PushScanner *self)
+{
+	self->finished = true;
+}
+
+ScanResult PushScanner_next(PushScanner *self, Token *out)
+{
+	CharItr *itr = &(self->chunk);
+	Str *carry = &(self->carry);
+	if (self->emitted > 0) {
+		Str_splice(carry, 0, self->emitted, NULL, 0);
+		self->emitted = 0;
+	}
+
+	if (self->state == STATE_STOP) {
+		if (Str_length(carry) == 0) {
+			skip_spaces(itr);
+			if (itr->cursor == itr->sentinel) {
+				if (!self->finished) {
+					return SCAN_NEED_INPUT;
+				}
+				make_token(out, END_TOKEN, itr->cursor, 0);
+				return SCAN_TOKEN;
+			}
+			switch (CHAR_CLASS[(unsigned char) *itr->cursor]) {
+				case CLASS_NEWLINE:
+					make_token(out, END_TOKEN, itr->cursor, 0);
+					itr->cursor++;
+					return SCAN_TOKEN;
+				case CLASS_END:
+					make_token(out, END_TOKEN, itr->cursor, 1);
+					itr->cursor++;
+					return SCAN_TOKEN;
+			}
+		}
+		// Backed up chars left in the carry always start a token
+		self->state = STATE_START;
+		self->type = REJECT;
+		self->accepted = 0;
+	}
+
+	// Carried chars the machine has yet to run over come before the chunk
+	const char *carried = Str_cstr(carry);
+	size_t carry_length = Str_length(carry);
+	uint8_t state = self->state;
+	while (self->carry_scanned < carry_length) {
+		state = TRANSITIONS[state][CHAR_CLASS[(unsigned char) carried[self->carry_scanned]]];
+		if (state == STATE_STOP) {
+			break;
+		}
+		self->carry_scanned++;
+		if (ACCEPTS[state] != REJECT) {
+			self->type = ACCEPTS[state];
+			self->accepted = self->carry_scanned;
+		}
+	}
+
+	const char *start = itr->cursor;
+	while (state != STATE_STOP && itr->cursor < itr->sentinel) {
+		state = TRANSITIONS[state][CHAR_CLASS[(unsigned char) *itr->cursor]];
+		if (state == STATE_STOP) {
+			break;
+		}
+		itr->cursor++;
+		if (ACCEPTS[state] != REJECT) {
+			self->type = ACCEPTS[state];
+			self->accepted = carry_length + (itr->cursor - start);
+		}
+	}
+
+	if (state != STATE_STOP && !self->finished) {
+		// Out of chunk mid-token: carry its chars over to the next one
+		Str_append_n(carry, start, itr->cursor - start);
+		self->carry_scanned = Str_length(carry);
+		self->state = state;
+		return SCAN_NEED_INPUT;
+	}
+
+	size_t accepted = self->accepted;
+	self->state = STATE_STOP;
+	self->carry_scanned = 0;
+	if (carry_length == 0) {
+		// The common case: the whole token is in the chunk
+		itr->cursor = start + accepted;
+		make_token(out, self->type, start, accepted);
+	} else if (accepted >= carry_length) {
+		Str_append_n(carry, start, accepted - carry_length);
+		itr->cursor = start + (accepted - carry_length);
+		self->emitted = accepted;
+		make_token(out, self->type, Str_cstr(carry), accepted);
+	} else {
+		// Backed up into the carry: what follows the token is scanned again
+		itr->cursor = start;
+		self->emitted = accepted;
+		make_token(out, self->type, Str_cstr(carry), accepted);
+	}
+	return SCAN_TOKEN;
 }
@@ -2,10 +2,12 @@
 #include <string.h>
 #include <stdio.h>
 
+#include "Kernels.h"
 #include "Str.h"
 #include "Vec.h"
 
 static char NULL_CHAR = '\0';
+static const CharSet NULL_SET = { 1, { '\0' } };
 
 Str Str_value(size_t capacity)
 {
@@ -14,6 +16,23 @@ Str Str_value(size_t capacity)
     return s;
 }
 
+Str Str_inline(void)
+{
+    Str s = Vec_inline(sizeof(char));
+    CharVec_append(&s, NULL_CHAR);
+    return s;
+}
+
+Str Str_inline_from_n(const char *bytes, size_t length)
+{
+    Str s = length < VEC_INLINE_BYTES
+        ? Vec_inline(sizeof(char))
+        : Vec_value(length + 1, sizeof(char));
+    Vec_extend(&s, bytes, length);
+    CharVec_append(&s, NULL_CHAR);
+    return s;
+}
+
 void Str_drop(Str *self)
 {
     Vec_drop(self);
@@ -26,23 +45,24 @@ size_t Str_length(const Str *self)
 
 const char* Str_cstr(const Str *self)
 {
-    return (char*) Vec_ref(self, 0);
+    return CharVec_at_unchecked(self, 0);
 }
 
 char* Str_ref(const Str *self, const size_t index)
 {
-    return (char*) Vec_ref(self, index);
+    return CharVec_at(self, index);
 }
 
 Str Str_from(const char *cstr)
 {
-	Str s = Str_value(0);
-	size_t i = 0;
-	while (cstr[i] != NULL_CHAR) {
-		Vec_splice(&s, i, 0, cstr+i, 1);
-		i++;
-	}
+	return Str_from_n(cstr, Kernel_length(cstr));
+}
 
+Str Str_from_n(const char *bytes, size_t length)
+{
+	Str s = Vec_value(length + 1, sizeof(char));
+	Vec_extend(&s, bytes, length);
+	CharVec_append(&s, NULL_CHAR);
 	return s;
 }
 
@@ -54,16 +74,9 @@ void Str_splice(Str *self, size_t index, size_t delete_count, const char *cstr,
         	exit(EXIT_FAILURE);
 	}
 
-	size_t len = 0;
-	const char *current = cstr;
-	while (current != NULL && *current != NULL_CHAR) {
-		len++;
-		current++;
-	}
-
 	// Likely unnecessary but an extra precaution to prevent a second null terminator from being
-	// spliced into the middle of a Str
-	if (insert_count > len) {
+	// spliced into the middle of a Str. Only the chars being inserted need to be scanned.
+	if (insert_count > 0 && (cstr == NULL || Kernel_find_any(cstr, insert_count, &NULL_SET) != insert_count)) {
         	fprintf(stderr, "%s:%d - Out of Bounds", __FILE__, __LINE__);
         	exit(EXIT_FAILURE);
 	}
@@ -73,10 +86,20 @@ void Str_splice(Str *self, size_t index, size_t delete_count, const char *cstr,
 
 void Str_append(Str *self, const char *cstr)
 {
-	while (*cstr != NULL_CHAR) {
-		Vec_splice(self, Str_length(self), 0, cstr, 1);
-		cstr++;
-	}
+	Str_append_n(self, cstr, Kernel_length(cstr));
+}
+
+void Str_append_n(Str *self, const char *bytes, size_t length)
+{
+	// Overwrite the null terminator and terminate again after the new chars
+	Vec_truncate(self, Str_length(self));
+	Vec_extend(self, bytes, length);
+	CharVec_append(self, NULL_CHAR);
+}
+
+void Str_append_str(Str *self, const Str *other)
+{
+	Str_append_n(self, Str_cstr(other), Str_length(other));
 }
 
 char Str_get(const Str *self, size_t index)
@@ -87,9 +110,7 @@ char Str_get(const Str *self, size_t index)
         	exit(EXIT_FAILURE);
 	}
 	
-	char out;
-	Vec_get(self, index, &out);
-	return out;
+	return *CharVec_at_unchecked(self, index);
 }
 
 void Str_set(Str *self, size_t index, const char value)
@@ -98,8 +119,10 @@ void Str_set(Str *self, size_t index, const char value)
         	fprintf(stderr, "%s:%d - Out of Bounds", __FILE__, __LINE__);
         	exit(EXIT_FAILURE);
 	} else if (index == Str_length(self)) {
-		Vec_splice(self, Str_length(self), 0, &value, 1);
+		// Overwrite the null terminator and push a new one after it
+		*CharVec_at_unchecked(self, index) = value;
+		CharVec_append(self, NULL_CHAR);
 	} else {
-		Vec_set(self, index, &value);
+		*CharVec_at_unchecked(self, index) = value;
 	}
 }
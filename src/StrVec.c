@@ -13,7 +13,7 @@ size_t StrVec_length(const StrVec *self)
 
 Str* StrVec_ref(const StrVec *self, size_t index)
 {
-    return Vec_ref(self, index);
+    return StrVec_at(self, index);
 }
 
 bool StrVec_empty(const StrVec *self)
@@ -23,15 +23,14 @@ bool StrVec_empty(const StrVec *self)
 
 void StrVec_push(StrVec *self, Str value)
 {
-    Vec_set(self, Vec_length(self), &value);
+    StrVec_append(self, value);
 }
 
 Str StrVec_pop(StrVec *self)
 {
-    Str s;
     size_t index = Vec_length(self) - 1;
-    Vec_get(self, index, &s);
-    Vec_splice(self, index, 1, NULL, 0);
+    Str s = StrVec_load(self, index);
+    Vec_truncate(self, index);
     return s;
 }
 
@@ -46,9 +45,10 @@ void StrVec_set(StrVec *self, size_t index, const Str value)
 
 void StrVec_drop(StrVec *self)
 {
-    while (!StrVec_empty(self)) {
-        Str s = StrVec_pop(self);
-        Str_drop(&s);
+    // One pass over the Strs, rather than a pop and splice for each
+    size_t length = Vec_length(self);
+    for (size_t i = 0; i < length; ++i) {
+        Str_drop(StrVec_at_unchecked(self, i));
     }
     Vec_drop(self);
 }
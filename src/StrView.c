@@ -0,0 +1,149 @@
+#include <string.h>
+
+#include "Guards.h"
+#include "Map.h"
+
+#include "StrView.h"
+
+/* Constructors */
+
+StrView StrView_value(const char *start, size_t length)
+{
+    StrView view = {
+        start,
+        length
+    };
+    return view;
+}
+
+StrView StrView_from_cstr(const char *cstr)
+{
+    return StrView_value(cstr, strlen(cstr));
+}
+
+StrView StrView_of_Str(const Str *str)
+{
+    return StrView_value(Str_cstr(str), Str_length(str));
+}
+
+Str StrView_to_Str(const StrView *self)
+{
+    return Str_from_n(self->start, self->length);
+}
+
+/* Accessors */
+
+size_t StrView_length(const StrView *self)
+{
+    return self->length;
+}
+
+char StrView_get(const StrView *self, size_t index)
+{
+    if (index >= self->length) {
+        OOB_PANIC(__FILE__, __LINE__);
+    }
+    return self->start[index];
+}
+
+StrView StrView_slice(const StrView *self, size_t index, size_t length)
+{
+    if (index > self->length || length > self->length - index) {
+        OOB_PANIC(__FILE__, __LINE__);
+    }
+    return StrView_value(self->start + index, length);
+}
+
+/* Comparison and Hashing */
+
+bool StrView_equals(const StrView *self, const StrView *other)
+{
+    return self->length == other->length &&
+        memcmp(self->start, other->start, self->length) == 0;
+}
+
+bool StrView_equals_cstr(const StrView *self, const char *cstr)
+{
+    // Find cstr's terminator first; memchr stops there, and the view may hold NULs
+    const char *end = (const char*) memchr(cstr, '\0', self->length + 1);
+    return end == cstr + self->length && memcmp(self->start, cstr, self->length) == 0;
+}
+
+int StrView_compare(const StrView *self, const StrView *other)
+{
+    size_t shorter = self->length < other->length ? self->length : other->length;
+    int order = memcmp(self->start, other->start, shorter);
+    if (order != 0) {
+        return order;
+    }
+    return (self->length > other->length) - (self->length < other->length);
+}
+
+uint64_t StrView_hash(const StrView *self)
+{
+    return Map_hash_bytes(self->start, self->length);
+}
+
+/* Searching */
+
+size_t StrView_find(const StrView *self, char c)
+{
+    const char *found = memchr(self->start, c, self->length);
+    return found != NULL ? (size_t) (found - self->start) : STR_VIEW_NPOS;
+}
+
+size_t StrView_find_any(const StrView *self, const char *set)
+{
+    for (size_t i = 0; i < self->length; ++i) {
+        if (strchr(set, self->start[i]) != NULL && self->start[i] != '\0') {
+            return i;
+        }
+    }
+    return STR_VIEW_NPOS;
+}
+
+size_t StrView_find_view(const StrView *self, const StrView *needle)
+{
+    if (needle->length == 0) {
+        return 0;
+    }
+    if (needle->length > self->length) {
+        return STR_VIEW_NPOS;
+    }
+    size_t last = self->length - needle->length;
+    for (size_t i = 0; i <= last; ++i) {
+        const char *candidate = memchr(self->start + i, needle->start[0], last - i + 1);
+        if (candidate == NULL) {
+            break;
+        }
+        i = candidate - self->start;
+        if (memcmp(candidate, needle->start, needle->length) == 0) {
+            return i;
+        }
+    }
+    return STR_VIEW_NPOS;
+}
+
+/* Splitting */
+
+bool StrView_split(StrView *rest, const char *delimiters, StrView *field)
+{
+    size_t start = 0;
+    while (start < rest->length && strchr(delimiters, rest->start[start]) != NULL &&
+            rest->start[start] != '\0') {
+        start++;
+    }
+    if (start == rest->length) {
+        *rest = StrView_value(rest->start + start, 0);
+        return false;
+    }
+
+    StrView remaining = StrView_value(rest->start + start, rest->length - start);
+    size_t end = StrView_find_any(&remaining, delimiters);
+    if (end == STR_VIEW_NPOS) {
+        end = remaining.length;
+    }
+    *field = StrView_value(remaining.start, end);
+    *rest = StrView_value(remaining.start + end, remaining.length - end);
+    return true;
+}
@@ -0,0 +1,56 @@
+#include "Kernels.h"
+
+#include "StructuralIndex.h"
+
+#define BLOCKS (STRUCTURAL_WINDOW / 64)
+
+// A char holding EOF reads as 0xFF, which the Scanner treats as an end char.
+// Quoting chars are structural so that a quoted word ends its index entry.
+static const CharSet STRUCTURAL = { 12, " \t\n|&><'\"\\\0\xff" };
+static const CharSet SPACES = { 2, " \t" };
+
+StructuralIndex StructuralIndex_value(void)
+{
+    StructuralIndex index;
+    index.base = NULL;
+    index.length = 0;
+    index.count = 0;
+    index.next = 0;
+    return index;
+}
+
+void StructuralIndex_build(StructuralIndex *self, const char *base, size_t length)
+{
+    if (length > STRUCTURAL_WINDOW) {
+        length = STRUCTURAL_WINDOW;
+    }
+    self->base = base;
+    self->length = (uint16_t) length;
+    self->count = 0;
+    self->next = 0;
+
+    uint64_t structural[BLOCKS];
+    uint64_t spaces[BLOCKS];
+    Kernel_classify(base, length, &STRUCTURAL, structural);
+    Kernel_classify(base, length, &SPACES, spaces);
+
+    // The char before base is never part of a word
+    uint64_t carry = 0;
+    for (size_t block = 0; block * 64 < length; ++block) {
+        size_t valid = length - block * 64;
+        uint64_t in_range = valid >= 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << valid) - 1;
+        uint64_t words = ~structural[block] & in_range;
+        uint64_t follows_word = words << 1 | carry;
+        carry = words >> 63;
+
+        uint64_t word_starts = words & ~follows_word;
+        uint64_t word_ends = ~words & follows_word & in_range;
+        uint64_t others = structural[block] & ~spaces[block];
+
+        uint64_t entries = word_starts | word_ends | others;
+        while (entries != 0) {
+            self->offsets[self->count++] = (uint8_t) (block * 64 + __builtin_ctzll(entries));
+            entries &= entries - 1;
+        }
+    }
+}
@@ -1,30 +1,68 @@
+/* mremap is a Linux extension */
+#define _GNU_SOURCE
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #include "Guards.h"
 
 #include "Vec.h"
 
 static void _ensure_capacity(Vec *self, size_t n);
+static void _relocate(Vec *self, size_t capacity);
+static void _release(Vec *self);
+static size_t _page_round(size_t bytes);
+static uint32_t _item_size(size_t item_size);
+
+static const VecGrowth DEFAULT_GROWTH = { 2, 1, 0, 0 };
+static VecGrowth growth = { 2, 1, 0, 0 };
 
 /* Constructor / Destructor */
 
 Vec Vec_value(size_t capacity, size_t item_size)
+{
+    return Vec_value_in(capacity, item_size, Allocator_default());
+}
+
+Vec Vec_value_in(size_t capacity, size_t item_size, const Allocator *allocator)
 {
     Vec vec = {
-        item_size,
+        _item_size(item_size),
+        false,
         0,
         capacity,
-        calloc(capacity, item_size)
+        NULL,
+        allocator
+    };
+    // A zero capacity Vec behaves as an inline Vec with no room
+    if (capacity * item_size > 0) {
+        vec.buffer = Allocator_alloc(allocator, capacity * item_size);
+        OOM_GUARD(vec.buffer, __FILE__, __LINE__);
+        memset(vec.buffer, 0, capacity * item_size);
+    }
+    return vec;
+}
+
+Vec Vec_inline(size_t item_size)
+{
+    Vec vec = {
+        _item_size(item_size),
+        false,
+        0,
+        VEC_INLINE_BYTES / item_size,
+        NULL,
+        Allocator_default()
     };
-    OOM_GUARD(vec.buffer, __FILE__, __LINE__);
     return vec;
 }
 
 void Vec_drop(Vec *self)
 {
-    free(self->buffer);
+    _release(self);
     self->buffer = NULL;
     self->capacity = 0;
     self->length = 0;
@@ -37,10 +75,15 @@ size_t Vec_length(const Vec *self)
     return self->length;
 }
 
+size_t Vec_capacity(const Vec *self)
+{
+    return self->capacity;
+}
+
 void* Vec_ref(const Vec *self, size_t index)
 {
     if (index < self->length) {
-        return self->buffer + (index * self->item_size);
+        return (char*) Vec_data(self) + (index * self->item_size);
     } else {
         fprintf(stderr, "%s:%d - Out of Bounds", __FILE__, __LINE__);
         exit(EXIT_FAILURE);
@@ -52,7 +95,7 @@ void* Vec_ref(const Vec *self, size_t index)
 void Vec_get(const Vec *self, size_t index, void *out)
 {
 	if (index >= 0 && index < self->length) {
-  		memcpy(out, Vec_ref(self, index), self->item_size);
+  		memcpy(out, (char*) Vec_data(self) + index * self->item_size, self->item_size);
 	} else {
         	fprintf(stderr, "%s:%d - Out of Bounds", __FILE__, __LINE__);
         	exit(EXIT_FAILURE);
@@ -62,9 +105,9 @@ void Vec_get(const Vec *self, size_t index, void *out)
 void Vec_set(Vec *self, size_t index, const void *value)
 {
 	if (index >= 0 && index < self->length) {
-		Vec_splice(self, index, 1, value, 1);
+		memcpy((char*) Vec_data(self) + index * self->item_size, value, self->item_size);
 	} else if (index == self->length) {
-		Vec_splice(self, index, 0, value, 1);
+		Vec_push(self, value);
 	} else {
         	fprintf(stderr, "%s:%d - Out of Bounds", __FILE__, __LINE__);
         	exit(EXIT_FAILURE);
@@ -76,47 +119,221 @@ bool Vec_equals(const Vec *self, const Vec *other)
 	if (self->length != other->length || self->item_size != other->item_size) {
 		return false;
 	}	
-	return memcmp(self->buffer, other->buffer, self->length * self->item_size) == 0;
+	return memcmp(Vec_data(self), Vec_data(other), self->length * self->item_size) == 0;
 }
 
 void Vec_splice(Vec *self, size_t index, size_t delete_count, const void *items, size_t insert_count)
 {
-	// Inserting beyond Vec length only occurs when index>self->length, which this also covers
-	if (delete_count < 0 || insert_count < 0 || index+delete_count > self->length) {
+	// Inserting beyond Vec length only occurs when index>self->length, which this also covers.
+	// Negative counts wrap around to huge unsigned values and overflow the length.
+	if (delete_count > self->length || insert_count > SIZE_MAX - self->length ||
+			index+delete_count > self->length) {
         	fprintf(stderr, "%s:%d - Out of Bounds", __FILE__, __LINE__);
         	exit(EXIT_FAILURE);
 	}
 
 	size_t oldLength = self->length;
 	size_t newLength = self->length-delete_count+insert_count;
-
-	if (newLength > self->length) {
-		_ensure_capacity(self, newLength);
-		self->length = newLength; // Necessary to update to higher length for Vec_ref usage later
-	}
+	_ensure_capacity(self, newLength);
 
 	// Either moving the last part (block) of the array left to cover deleted items or
-	// moving it right to make space for items to be inserted
+	// moving it right to make space for items to be inserted. The ranges may overlap.
+	char *buffer = (char*) Vec_data(self);
 	size_t blockStart = index+delete_count;
 	size_t blockLength = (oldLength-blockStart)*self->item_size;
-	size_t shift = insert_count-delete_count;
-	if (blockLength > 0) {
-		memcpy(Vec_ref(self, blockStart+shift), Vec_ref(self, blockStart), blockLength);
+	if (blockLength > 0 && insert_count != delete_count) {
+		memmove(buffer + (index+insert_count)*self->item_size,
+			buffer + blockStart*self->item_size,
+			blockLength);
 	}
 
 	// Insert from the items array
-	memcpy(Vec_ref(self, index), items, insert_count*self->item_size);
+	if (insert_count > 0) {
+		memcpy(buffer + index*self->item_size, items, insert_count*self->item_size);
+	}
 	self->length = newLength;
 }
 
+/* Bulk Operations */
+
+void Vec_reserve(Vec *self, size_t capacity)
+{
+	if (capacity > self->capacity) {
+		_relocate(self, capacity);
+	}
+}
+
+void Vec_extend(Vec *self, const void *items, size_t count)
+{
+	if (count == 0) {
+		return;
+	}
+	_ensure_capacity(self, self->length + count);
+	memcpy((char*) Vec_data(self) + self->length * self->item_size, items, count * self->item_size);
+	self->length += count;
+}
+
+void Vec_push(Vec *self, const void *item)
+{
+	Vec_extend(self, item, 1);
+}
+
+void Vec_truncate(Vec *self, size_t length)
+{
+	if (length > self->length) {
+        	fprintf(stderr, "%s:%d - Out of Bounds", __FILE__, __LINE__);
+        	exit(EXIT_FAILURE);
+	}
+	self->length = length;
+}
+
+void* Vec_spare(const Vec *self)
+{
+	return (char*) Vec_data(self) + self->length * self->item_size;
+}
+
+void Vec_set_length(Vec *self, size_t length)
+{
+	if (length > self->capacity) {
+        	fprintf(stderr, "%s:%d - Out of Bounds", __FILE__, __LINE__);
+        	exit(EXIT_FAILURE);
+	}
+	self->length = length;
+}
+
+/* Capacity Policy */
+
+VecGrowth Vec_growth(void)
+{
+	return growth;
+}
+
+bool Vec_set_growth(const VecGrowth *policy)
+{
+	if (policy == NULL) {
+		growth = DEFAULT_GROWTH;
+		return true;
+	}
+	// Growing by a factor below 1 would add one item at a time
+	if (policy->factor_denominator == 0 ||
+			policy->factor_numerator < policy->factor_denominator) {
+		return false;
+	}
+	growth = *policy;
+	return true;
+}
+
+void Vec_shrink_to(Vec *self, size_t capacity)
+{
+	if (capacity < self->length) {
+		capacity = self->length;
+	}
+	if (self->buffer == NULL || capacity >= self->capacity) {
+		return;
+	}
+
+	size_t bytes = self->length * self->item_size;
+	if (capacity * self->item_size <= VEC_INLINE_BYTES) {
+		// Small enough to bring the items back inline and free the buffer
+		memcpy(self->inline_buffer, self->buffer, bytes);
+		_release(self);
+		self->buffer = NULL;
+		self->capacity = VEC_INLINE_BYTES / self->item_size;
+	} else {
+		_relocate(self, capacity);
+	}
+}
+
+void Vec_shrink_to_fit(Vec *self)
+{
+	Vec_shrink_to(self, 0);
+}
+
 /* Helpers */
 
+/* item_size is stored in 32 bits to keep the Vec in one cache line */
+static uint32_t _item_size(size_t item_size)
+{
+    if (item_size > UINT32_MAX) {
+        fprintf(stderr, "%s:%d - Item size too large", __FILE__, __LINE__);
+        exit(EXIT_FAILURE);
+    }
+    return (uint32_t) item_size;
+}
+
 static void _ensure_capacity(Vec *self, size_t n) 
 {
     if (n > self->capacity) {
-        size_t new_capacity = n * 2;
-        self->buffer = realloc(self->buffer, new_capacity * self->item_size);
+        size_t new_capacity = n * growth.factor_numerator / growth.factor_denominator;
+        if (new_capacity < n) {
+            new_capacity = n;
+        }
+        if (growth.round_bytes > 0) {
+            size_t bytes = new_capacity * self->item_size;
+            bytes = (bytes + growth.round_bytes - 1) / growth.round_bytes * growth.round_bytes;
+            new_capacity = bytes / self->item_size;
+        }
+        _relocate(self, new_capacity);
+    }
+}
+
+/* Move the items to a heap buffer of `capacity` items, spilling inline items */
+static void _relocate(Vec *self, size_t capacity)
+{
+    size_t bytes = capacity * self->item_size;
+
+    if (self->mapped) {
+        // Remap the pages, letting the kernel move them rather than copy
+        size_t mapped_bytes = _page_round(bytes);
+        void *pages = mremap(self->buffer, _page_round(self->capacity * self->item_size),
+                mapped_bytes, MREMAP_MAYMOVE);
+        OOM_GUARD(pages == MAP_FAILED ? NULL : pages, __FILE__, __LINE__);
+        self->buffer = pages;
+        self->capacity = mapped_bytes / self->item_size;
+        return;
+    }
+
+    if (growth.map_threshold > 0 && bytes >= growth.map_threshold &&
+            self->allocator == Allocator_system()) {
+        // Crossing into large-buffer mode costs one final copy
+        size_t mapped_bytes = _page_round(bytes);
+        void *pages = mmap(NULL, mapped_bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        OOM_GUARD(pages == MAP_FAILED ? NULL : pages, __FILE__, __LINE__);
+        memcpy(pages, Vec_data(self), self->length * self->item_size);
+        _release(self);
+        self->buffer = pages;
+        self->mapped = true;
+        self->capacity = mapped_bytes / self->item_size;
+        return;
+    }
+
+    if (self->buffer == NULL) {
+        void *heap = Allocator_alloc(self->allocator, bytes);
+        OOM_GUARD(heap, __FILE__, __LINE__);
+        memcpy(heap, self->inline_buffer, self->length * self->item_size);
+        self->buffer = heap;
+    } else {
+        self->buffer = Allocator_realloc(self->allocator, self->buffer,
+                self->capacity * self->item_size, bytes);
         OOM_GUARD(self->buffer, __FILE__, __LINE__);
-        self->capacity = new_capacity;
     }
+    self->capacity = capacity;
+}
+
+/* Return the buffer's memory to wherever it came from */
+static void _release(Vec *self)
+{
+    if (self->mapped) {
+        munmap(self->buffer, _page_round(self->capacity * self->item_size));
+        self->mapped = false;
+    } else if (self->buffer != NULL) {
+        Allocator_free(self->allocator, self->buffer, self->capacity * self->item_size);
+    }
+}
+
+static size_t _page_round(size_t bytes)
+{
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    return (bytes + page - 1) / page * page;
 }
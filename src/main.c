@@ -1,7 +1,15 @@
+/* isatty is POSIX, not C11 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
+#include "CharStream.h"
+#include "MappedFile.h"
 #include "Str.h"
 #include "Scanner.h"
 #include "Parser.h"
@@ -9,39 +17,133 @@
 
 #define BUFF_SIZE 80 
 
+// Once an outlier line grows the line buffer past this many chars,
+// its capacity is handed back before reading the next line. The parser
+// drops its recycled command buffers past the same mark.
+#define LINE_HIGH_WATER PARSE_HIGH_WATER
+
+// Input that is not a terminal is scanned straight from stdin in
+// chunks of this many chars, so memory does not grow with line length.
+#define STREAM_CHUNK (64 * 1024)
+
 /**
  * This program reads an input line from stdin and prints textual
  * representations of the tokens scanned from lines of input.
+ *
+ * Usage: thsh [script]
+ * Given a script, its lines are run from a memory mapping of the file,
+ * or, when it is a pipe or FIFO such as <(...), as they are read.
  */
 
 // These three functions provide the basis of a REPL:
 // Read-Evaluate-Print-Loop
-size_t read(Str *line, FILE *stream);
-Node* eval(Str *input);
+size_t read_line(Str *line, FILE *stream);
+Node* eval(Scanner *scanner, Str *input);
 void print(Node *node, size_t indention);
 
-int main()
+static int run_script(const char *path);
+static int run_stream(int fd, const char *name, bool prompt);
+static void run_lines(Scanner *scanner, bool prompt);
+
+int main(int argc, char *argv[])
 {
+    if (argc > 1) {
+        return run_script(argv[1]);
+    }
+    if (!isatty(STDIN_FILENO)) {
+        return run_stream(STDIN_FILENO, "stdin", true);
+    }
+
+    // One Scanner serves the whole session, reset onto each line
     Str line = Str_value(BUFF_SIZE);
-    while (read(&line, stdin)) {
-        Node *parse_tree = eval(&line);
+    Scanner scanner = Scanner_value(CharItr_of_Str(&line));
+    while (read_line(&line, stdin)) {
+        Node *parse_tree = eval(&scanner, &line);
         exec(parse_tree);
-        Node_drop(parse_tree);
+        parse_recycle(parse_tree);
     }
+    parse_release();
+    Scanner_drop(&scanner);
     Str_drop(&line);
     return EXIT_SUCCESS;
 }
 
-size_t read(Str *line, FILE *stream) {
+// Scan and run a script's lines in place in a mapping of the file.
+static int run_script(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    MappedFile script;
+    if (MappedFile_open_fd(fd, &script)) {
+        close(fd);
+        Scanner scanner = Scanner_value(CharItr_of_MappedFile(&script));
+        run_lines(&scanner, false);
+        Scanner_drop(&scanner);
+        MappedFile_drop(&script);
+    } else if (errno == ENODEV) {
+        // Only a regular file can be mapped; anything else is streamed
+        int status = run_stream(fd, path, false);
+        close(fd);
+        return status;
+    } else {
+        perror(path);
+        close(fd);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Scan and run each line of a script as it arrives, never holding more
+// than a chunk of it, plus the longest word, in memory. A failed read
+// ends the script like its end would, so report it here.
+static int run_stream(int fd, const char *name, bool prompt)
+{
+    CharStream stream = CharStream_value(fd, STREAM_CHUNK);
+    Scanner scanner = Scanner_value(CharItr_of_stream(&stream));
+    run_lines(&scanner, prompt);
+    int error = CharStream_error(&stream);
+    Scanner_drop(&scanner);
+    CharStream_drop(&stream);
+    if (error != 0) {
+        errno = error;
+        perror(name);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+static void run_lines(Scanner *scanner, bool prompt)
+{
+    do {
+        if (prompt) {
+            printf("thsh> ");
+        }
+        fflush(stdout);
+        Node *parse_tree = parse(scanner);
+        exec(parse_tree);
+        parse_recycle(parse_tree);
+    } while (Scanner_next_line(scanner));
+    parse_release();
+}
+
+size_t read_line(Str *line, FILE *stream) {
     printf("thsh> ");
 
-    // Clear Str contents.
+    // Clear Str contents and reclaim memory left over from a huge line.
     Str_splice(line, 0, Str_length(line), NULL, 0);
+    if (Vec_capacity(line) > LINE_HIGH_WATER) {
+        Vec_shrink_to(line, BUFF_SIZE + 1);
+    }
 
     static char buffer[BUFF_SIZE];
     while (fgets(buffer, BUFF_SIZE, stream) != NULL) {
-        Str_append(line, buffer);
-        if (strchr(buffer, '\n') != NULL) {
+        // fgets stops after a newline, so only the last char can be one
+        size_t length = strlen(buffer);
+        Str_append_n(line, buffer, length);
+        if (length > 0 && buffer[length - 1] == '\n') {
             break;
         }
     }
@@ -49,9 +151,9 @@ size_t read(Str *line, FILE *stream) {
     return Str_length(line);
 }
 
-Node* eval(Str *line) {
-    Scanner scanner = Scanner_value(CharItr_of_Str(line));
-    return parse(&scanner);
+Node* eval(Scanner *scanner, Str *line) {
+    Scanner_reset(scanner, CharItr_of_Str(line));
+    return parse(scanner);
 }
 
 void print(Node *node, size_t indention) {
@@ -63,9 +165,8 @@ void print(Node *node, size_t indention) {
             break;
         case COMMAND_NODE:
             printf("COMMAND:");
-            StrVec *words = &node->data.command;
-            for (size_t i = 0; i < StrVec_length(words); ++i) {
-                printf(" %s", Str_cstr(StrVec_ref(words, i)));
+            for (size_t i = 0; i < Command_length(&node->data.command); ++i) {
+                printf(" %s", Command_word(&node->data.command, i));
             }
             putchar('\n');
             break;
@@ -0,0 +1,59 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/* clock_gettime is POSIX, not C11. Must precede any system header. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "Str.h"
+
+/*
+ * Shared helpers for the programs under test/bench. Each benchmark is a
+ * standalone program linked against the project's objects (minus main.c)
+ * and run by `make bench`.
+ */
+
+/* Seconds elapsed on a monotonic clock. */
+static inline double Bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/* Print a throughput line in MB/s for `bytes` processed in `seconds`. */
+static inline void Bench_report(const char *name, size_t bytes, double seconds)
+{
+    printf("%-44s %10.2f MB/s %10.3f s\n", name, (double) bytes / seconds / 1e6, seconds);
+}
+
+/* Print a rate line in millions of operations per second. */
+static inline void Bench_report_ops(const char *name, size_t ops, double seconds)
+{
+    printf("%-44s %10.2f Mop/s %9.3f s\n", name, (double) ops / seconds / 1e6, seconds);
+}
+
+/*
+ * Fill `out` with at least `bytes` of newline separated command lines
+ * resembling an interactive or scripted shell workload.
+ */
+static inline void Bench_corpus(Str *out, size_t bytes)
+{
+    static const char *lines[] = {
+        "ls -lah\n",
+        "grep -v foo bar.txt | sort | uniq -c\n",
+        "cat /var/log/syslog | grep -E error | tail -n 20\n",
+        "find . -name main.c -type f\n",
+        "echo hello world | tr a-z A-Z | less\n",
+        "git log --oneline --decorate --graph --all\n",
+    };
+    size_t count = sizeof(lines) / sizeof(lines[0]);
+    for (size_t i = 0; Str_length(out) < bytes; ++i) {
+        Str_append(out, lines[i % count]);
+    }
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include "Bench.h"
+
+#include "Kernels.h"
+
+/*
+ * Measures the string kernels at each level the CPU supports over a
+ * long run of argument text, so the speedup of each vector width over
+ * the scalar loop is visible side by side. The words run makes two
+ * calls per short word, so its cost is per call rather than per byte and
+ * does not grow with vector width.
+ */
+
+#define CORPUS_BYTES (16 * 1024 * 1024)
+#define ROUNDS 8
+
+static const char *LEVEL_NAMES[] = { "scalar", "sse2", "avx2" };
+static const CharSet WORD_DELIMITERS = { 5, " \t\n|\0" };
+
+static volatile size_t sink;
+
+static void run(const Str *corpus, const Str *copy, KernelLevel level)
+{
+    char name[64];
+    const char *bytes = Str_cstr(corpus);
+    size_t length = Str_length(corpus);
+
+    double start = Bench_now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        sink += Kernel_length(bytes);
+    }
+    snprintf(name, sizeof(name), "kernel %-6s: length", LEVEL_NAMES[level]);
+    Bench_report(name, length * ROUNDS, Bench_now() - start);
+
+    // Words are short, so scan for pipes to measure the steady state
+    static const CharSet PIPES = { 1, "|" };
+    start = Bench_now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (size_t i = 0; i < length; ++i) {
+            i += Kernel_find_any(bytes + i, length - i, &PIPES);
+            sink += i;
+        }
+    }
+    snprintf(name, sizeof(name), "kernel %-6s: find_any pipe", LEVEL_NAMES[level]);
+    Bench_report(name, length * ROUNDS, Bench_now() - start);
+
+    start = Bench_now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        size_t i = 0;
+        while (i < length) {
+            i += Kernel_skip_while(bytes + i, length - i, &WORD_DELIMITERS);
+            i += Kernel_find_any(bytes + i, length - i, &WORD_DELIMITERS);
+            sink += i;
+        }
+    }
+    snprintf(name, sizeof(name), "kernel %-6s: words", LEVEL_NAMES[level]);
+    Bench_report(name, length * ROUNDS, Bench_now() - start);
+
+    start = Bench_now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        sink += Kernel_equals(bytes, Str_cstr(copy), length);
+    }
+    snprintf(name, sizeof(name), "kernel %-6s: equals", LEVEL_NAMES[level]);
+    Bench_report(name, length * ROUNDS, Bench_now() - start);
+}
+
+int main()
+{
+    Str corpus = Str_value(CORPUS_BYTES);
+    Bench_corpus(&corpus, CORPUS_BYTES);
+    Str copy = Str_from(Str_cstr(&corpus));
+
+    printf("=== KernelBench ===\n");
+    KernelLevel best = Kernel_level();
+    for (int level = KERNEL_SCALAR; level <= KERNEL_AVX2; ++level) {
+        if (Kernel_set_level((KernelLevel) level) == level) {
+            run(&corpus, &copy, (KernelLevel) level);
+        }
+    }
+    Kernel_set_level(best);
+
+    Str_drop(&copy);
+    Str_drop(&corpus);
+    return EXIT_SUCCESS;
+}
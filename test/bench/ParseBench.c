@@ -0,0 +1,59 @@
+#include "Bench.h"
+
+#include "Parser.h"
+
+/*
+ * Measures parsing and tearing down generated commands, with each tree
+ * either dropped or recycled into the next parse. Recycling saves the
+ * allocations of short lines, where they are much of the work. A very
+ * long command outgrows PARSE_HIGH_WATER, so its buffers are dropped
+ * either way and the two runs should match. Each run reports the best
+ * of REPEATS, since the difference is small next to a noisy machine.
+ */
+
+#define WORDS 10000
+#define ROUNDS 200
+#define LINE_ROUNDS 300000
+#define REPEATS 5
+
+static void run(const char *name, const Str *line, int rounds, bool recycle)
+{
+    StrView input = StrView_of_Str(line);
+    double best = 0;
+    for (int repeat = 0; repeat < REPEATS; ++repeat) {
+        double start = Bench_now();
+        for (int round = 0; round < rounds; ++round) {
+            Node *tree = parse_view(&input);
+            if (recycle) {
+                parse_recycle(tree);
+            } else {
+                Node_drop(tree);
+            }
+        }
+        double seconds = Bench_now() - start;
+        best = repeat == 0 || seconds < best ? seconds : best;
+    }
+    Bench_report(name, Str_length(line) * rounds, best);
+    parse_release();
+}
+
+int main()
+{
+    Str line = Str_value(WORDS * 8);
+    char word[32];
+    for (int i = 0; i < WORDS; ++i) {
+        snprintf(word, sizeof(word), "--flag-%d ", i);
+        Str_append(&line, word);
+    }
+    Str pipeline = Str_from("grep -v foo bar.txt | sort | uniq -c");
+
+    printf("=== ParseBench ===\n");
+    run("parse: 3-command line, drop", &pipeline, LINE_ROUNDS, false);
+    run("parse: 3-command line, recycle", &pipeline, LINE_ROUNDS, true);
+    run("parse: 10k-word command, drop", &line, ROUNDS, false);
+    run("parse: 10k-word command, recycle", &line, ROUNDS, true);
+
+    Str_drop(&pipeline);
+    Str_drop(&line);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#include "Bench.h"
+
+#include "Scanner.h"
+
+/*
+ * Measures scanner throughput in bytes/sec over a corpus of command
+ * lines, and over operator-heavy lines. Compare `make bench` against
+ * `make PROFILE=release bench` to see the cost of bounds checking on
+ * the scanner's per-byte path. The command and operator corpora have
+ * no quoting, so they measure the fast path that quoted words leave.
+ * The long-word corpus of paths, hashes and URLs measures the kernel
+ * skip taken by words of 16 chars or more (LONG_WORD in Scanner.c).
+ * The whole-buffer runs scan each corpus
+ * as a single input, which is large enough to take the structural
+ * index path.
+ */
+
+#define CORPUS_BYTES (16 * 1024 * 1024)
+#define ROUNDS 4
+
+static volatile size_t sink;
+
+static void scan(const char *name, const Str *corpus)
+{
+    double start = Bench_now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        const char *cursor = Str_cstr(corpus);
+        const char *end = cursor + Str_length(corpus);
+        while (cursor < end) {
+            const char *newline = memchr(cursor, '\n', end - cursor);
+            size_t length = (newline != NULL ? newline + 1 : end) - cursor;
+            Scanner scanner = Scanner_value(CharItr_value(cursor, length));
+            while (Scanner_has_next(&scanner)) {
+                Token token = Scanner_next(&scanner);
+                sink += token.length;
+            }
+            cursor += length;
+        }
+    }
+    Bench_report(name, Str_length(corpus) * ROUNDS, Bench_now() - start);
+}
+
+static void scan_whole(const char *name, const Str *corpus)
+{
+    double start = Bench_now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        Scanner scanner = Scanner_value(CharItr_of_Str(corpus));
+        do {
+            while (Scanner_has_next(&scanner)) {
+                Token token = Scanner_next(&scanner);
+                sink += token.length;
+            }
+        } while (Scanner_next_line(&scanner));
+    }
+    Bench_report(name, Str_length(corpus) * ROUNDS, Bench_now() - start);
+}
+
+static void operator_corpus(Str *out, size_t bytes)
+{
+    static const char *lines[] = {
+        "make 2>&1 | tee build.log && make install || echo failed >> err.log\n",
+        "a|b||c&&d&e>f>>g<h 2>&1\n",
+        "sort < in.txt | uniq -c | sort -rn > out.txt &\n",
+    };
+    size_t count = sizeof(lines) / sizeof(lines[0]);
+    for (size_t i = 0; Str_length(out) < bytes; ++i) {
+        Str_append(out, lines[i % count]);
+    }
+}
+
+static void long_word_corpus(Str *out, size_t bytes)
+{
+    static const char *lines[] = {
+        "cp /usr/share/doc/libreadline-dev/changelog.Debian.gz /tmp/readline-changelog.gz\n",
+        "git checkout 3f9a1c0e7b5d2a4f6c8e0b1d3f5a7c9e1b3d5f70 -- src/StructuralIndex.c\n",
+        "curl --output linux-6.8.1.tar.xz https://cdn.kernel.org/pub/linux/kernel/v6.x/linux-6.8.1.tar.xz\n",
+    };
+    size_t count = sizeof(lines) / sizeof(lines[0]);
+    for (size_t i = 0; Str_length(out) < bytes; ++i) {
+        Str_append(out, lines[i % count]);
+    }
+}
+
+static void quoted_corpus(Str *out, size_t bytes)
+{
+    static const char *lines[] = {
+        "grep -r 'TODO: fix' src/ | sort > \"open items.txt\"\n",
+        "cp My\\ Documents/report.pdf 'Backup Drive/2024'\n",
+        "echo \"say \\\"hi\\\" to $USER\" | tee -a log.txt\n",
+    };
+    size_t count = sizeof(lines) / sizeof(lines[0]);
+    for (size_t i = 0; Str_length(out) < bytes; ++i) {
+        Str_append(out, lines[i % count]);
+    }
+}
+
+int main()
+{
+    Str corpus = Str_value(CORPUS_BYTES);
+    Bench_corpus(&corpus, CORPUS_BYTES);
+    Str operators = Str_value(CORPUS_BYTES);
+    operator_corpus(&operators, CORPUS_BYTES);
+    Str quoted = Str_value(CORPUS_BYTES);
+    quoted_corpus(&quoted, CORPUS_BYTES);
+    Str long_words = Str_value(CORPUS_BYTES);
+    long_word_corpus(&long_words, CORPUS_BYTES);
+
+    printf("=== ScannerBench ===\n");
+    scan("scanner: command corpus", &corpus);
+    scan("scanner: operator-heavy corpus", &operators);
+    scan("scanner: quoted corpus", &quoted);
+    scan("scanner: long-word corpus", &long_words);
+    scan_whole("scanner: command corpus, whole buffer", &corpus);
+    scan_whole("scanner: operator-heavy corpus, whole buffer", &operators);
+
+    Str_drop(&long_words);
+    Str_drop(&quoted);
+    Str_drop(&operators);
+    Str_drop(&corpus);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+#include "Bench.h"
+
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "CharStream.h"
+#include "MappedFile.h"
+#include "Parser.h"
+
+/*
+ * Parses every line of a 64 MB generated script three ways: the REPL's
+ * fgets/Str_append line reader, a CharStream over the fd, and a
+ * MappedFile scanned in place. Set THSH_BENCH_SCRIPT_MB=1024 for the
+ * full-size run. A script of one 3 MB line is then streamed and mapped,
+ * since a line many chunks long is where streaming has the most to lose.
+ */
+
+#define SCRIPT_MB_DEFAULT 64
+#define LONG_LINE_BYTES (3 * 1024 * 1024)
+#define LINE_BUFF 80
+
+static volatile size_t sink;
+
+static void parse_lines(Scanner *scanner)
+{
+    do {
+        Node *tree = parse(scanner);
+        sink += tree->type;
+        parse_recycle(tree);
+    } while (Scanner_next_line(scanner));
+}
+
+static void read_lines(const char *path, size_t bytes)
+{
+    double start = Bench_now();
+    FILE *file = fopen(path, "r");
+    Str line = Str_value(LINE_BUFF);
+    char buffer[LINE_BUFF];
+    for (;;) {
+        Str_splice(&line, 0, Str_length(&line), NULL, 0);
+        while (fgets(buffer, LINE_BUFF, file) != NULL) {
+            size_t length = strlen(buffer);
+            Str_append_n(&line, buffer, length);
+            if (buffer[length - 1] == '\n') {
+                break;
+            }
+        }
+        if (Str_length(&line) == 0) {
+            break;
+        }
+        StrView input = StrView_of_Str(&line);
+        Node *tree = parse_view(&input);
+        sink += tree->type;
+        parse_recycle(tree);
+    }
+    Str_drop(&line);
+    fclose(file);
+    parse_release();
+    Bench_report("script: fgets + Str_append per line", bytes, Bench_now() - start);
+}
+
+static void stream_lines(const char *name, const char *path, size_t bytes)
+{
+    double start = Bench_now();
+    int fd = open(path, O_RDONLY);
+    CharStream stream = CharStream_value(fd, 64 * 1024);
+    Scanner scanner = Scanner_value(CharItr_of_stream(&stream));
+    parse_lines(&scanner);
+    CharStream_drop(&stream);
+    close(fd);
+    parse_release();
+    Bench_report(name, bytes, Bench_now() - start);
+}
+
+static void mapped_lines(const char *name, const char *path, size_t bytes)
+{
+    double start = Bench_now();
+    MappedFile script;
+    if (!MappedFile_open(path, &script)) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    Scanner scanner = Scanner_value(CharItr_of_MappedFile(&script));
+    parse_lines(&scanner);
+    MappedFile_drop(&script);
+    parse_release();
+    Bench_report(name, bytes, Bench_now() - start);
+}
+
+int main()
+{
+    const char *megabytes = getenv("THSH_BENCH_SCRIPT_MB");
+    size_t bytes = (size_t) (megabytes != NULL ? atol(megabytes) : SCRIPT_MB_DEFAULT) * 1024 * 1024;
+
+    char path[] = "/tmp/thsh-script-bench-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return EXIT_FAILURE;
+    }
+    Str chunk = Str_value(1024 * 1024);
+    Bench_corpus(&chunk, 1024 * 1024);
+    size_t written = 0;
+    while (written < bytes) {
+        written += write(fd, Str_cstr(&chunk), Str_length(&chunk));
+    }
+    close(fd);
+    Str_drop(&chunk);
+
+    printf("=== ScriptBench ===\n");
+    read_lines(path, written);
+    stream_lines("script: CharStream over fd", path, written);
+    mapped_lines("script: MappedFile in place", path, written);
+
+    // Rewrite the script as a single line of words
+    fd = open(path, O_WRONLY | O_TRUNC);
+    Str line = Str_value(LONG_LINE_BYTES + 1);
+    while (Str_length(&line) < LONG_LINE_BYTES) {
+        Str_append(&line, "word ");
+    }
+    Str_append(&line, "\n");
+    written = write(fd, Str_cstr(&line), Str_length(&line));
+    close(fd);
+    Str_drop(&line);
+
+    stream_lines("script: 3 MB line, CharStream over fd", path, written);
+    mapped_lines("script: 3 MB line, MappedFile in place", path, written);
+
+    unlink(path);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,42 @@
+#include "Bench.h"
+
+#include "Vec.h"
+#include "Str.h"
+
+/*
+ * Grows a Str to 256 MB through Str_append, once with the default growth
+ * policy (realloc) and once with large-buffer mode (mmap/mremap).
+ */
+
+#define TARGET_BYTES (256u * 1024 * 1024)
+#define MAP_THRESHOLD (1024 * 1024)
+
+static void grow(const char *name, const char *chunk)
+{
+    double start = Bench_now();
+    Str s = Str_value(0);
+    while (Str_length(&s) < TARGET_BYTES) {
+        Str_append(&s, chunk);
+    }
+    double elapsed = Bench_now() - start;
+    Bench_report(name, Str_length(&s), elapsed);
+    Str_drop(&s);
+}
+
+int main()
+{
+    char chunk[257];
+    memset(chunk, 'x', sizeof(chunk) - 1);
+    chunk[sizeof(chunk) - 1] = '\0';
+
+    printf("=== StrGrowBench ===\n");
+    grow("Str_append to 256 MB: realloc", chunk);
+
+    VecGrowth policy = Vec_growth();
+    policy.map_threshold = MAP_THRESHOLD;
+    Vec_set_growth(&policy);
+    grow("Str_append to 256 MB: mmap/mremap", chunk);
+    Vec_set_growth(NULL);
+
+    return EXIT_SUCCESS;
+}
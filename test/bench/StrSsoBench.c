@@ -0,0 +1,102 @@
+#include "Bench.h"
+
+#include "Allocator.h"
+#include "Str.h"
+#include "Scanner.h"
+#include "Parser.h"
+
+/*
+ * Counts allocations and measures throughput for materializing the
+ * words of a command corpus as heap Strs (Str_from_n) versus inline
+ * small strings (Str_inline_from_n), then for end-to-end scan + parse.
+ */
+
+#define CORPUS_BYTES (16 * 1024 * 1024)
+
+static size_t allocations;
+static volatile size_t sink;
+
+static void* counting_alloc(void *user, size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void *user, void *ptr, size_t old_size, size_t new_size)
+{
+    allocations++;
+    return realloc(ptr, new_size);
+}
+
+static void counting_free(void *user, void *ptr, size_t size)
+{
+    free(ptr);
+}
+
+static const Allocator COUNTING_ALLOCATOR = {
+    counting_alloc,
+    counting_realloc,
+    counting_free,
+    NULL
+};
+
+static void words(const Str *corpus, const char *name, Str (*make)(const char*, size_t))
+{
+    const char *cursor = Str_cstr(corpus);
+    const char *end = cursor + Str_length(corpus);
+    size_t count = 0;
+
+    allocations = 0;
+    double start = Bench_now();
+    while (cursor < end) {
+        size_t length = strcspn(cursor, " \n");
+        if (length > 0) {
+            Str word = make(cursor, length);
+            sink += Str_length(&word);
+            Str_drop(&word);
+            count++;
+        }
+        cursor += length + 1;
+    }
+    double elapsed = Bench_now() - start;
+    Bench_report(name, Str_length(corpus), elapsed);
+    printf("%-44s %10.3f allocs/word\n", "", (double) allocations / count);
+}
+
+static void scan_and_parse(const Str *corpus)
+{
+    const char *cursor = Str_cstr(corpus);
+    const char *end = cursor + Str_length(corpus);
+    size_t lines = 0;
+
+    allocations = 0;
+    double start = Bench_now();
+    while (cursor < end) {
+        const char *newline = memchr(cursor, '\n', end - cursor);
+        size_t length = (newline != NULL ? newline + 1 : end) - cursor;
+        Scanner scanner = Scanner_value(CharItr_value(cursor, length));
+        Node *node = parse(&scanner);
+        Node_drop(node);
+        cursor += length;
+        lines++;
+    }
+    double elapsed = Bench_now() - start;
+    Bench_report("scan + parse", Str_length(corpus), elapsed);
+    printf("%-44s %10.3f allocs/line\n", "", (double) allocations / lines);
+}
+
+int main()
+{
+    Str corpus = Str_value(CORPUS_BYTES);
+    Bench_corpus(&corpus, CORPUS_BYTES);
+
+    printf("=== StrSsoBench ===\n");
+    Allocator_set_default(&COUNTING_ALLOCATOR);
+    words(&corpus, "words: heap Str_from_n", Str_from_n);
+    words(&corpus, "words: inline Str_inline_from_n", Str_inline_from_n);
+    scan_and_parse(&corpus);
+    Allocator_set_default(NULL);
+
+    Str_drop(&corpus);
+    return EXIT_SUCCESS;
+}
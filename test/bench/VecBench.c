@@ -0,0 +1,139 @@
+#include "Bench.h"
+
+#include "Vec.h"
+#include "Str.h"
+#include "StrVec.h"
+#include "Scanner.h"
+#include "Parser.h"
+
+/*
+ * Compares the untyped Vec API (runtime item_size) against the typed
+ * accessors generated by VEC_DEFINE on the access patterns of the
+ * scanner (char at a time lexeme building) and parser (Str words pushed
+ * onto a StrVec and read back), then measures end-to-end scan + parse.
+ */
+
+#define CORPUS_BYTES (16 * 1024 * 1024)
+#define ROUNDS 4
+
+static volatile size_t sink;
+
+static void scanner_untyped(const Str *corpus)
+{
+    const char *input = Str_cstr(corpus);
+    size_t length = Str_length(corpus);
+    double start = Bench_now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        Vec lexeme = Vec_value(1, sizeof(char));
+        for (size_t i = 0; i < length; ++i) {
+            if (input[i] == ' ' || input[i] == '\n') {
+                char last;
+                if (Vec_length(&lexeme) > 0) {
+                    Vec_get(&lexeme, Vec_length(&lexeme) - 1, &last);
+                    sink += last;
+                }
+                Vec_truncate(&lexeme, 0);
+            } else {
+                Vec_set(&lexeme, Vec_length(&lexeme), &input[i]);
+            }
+        }
+        Vec_drop(&lexeme);
+    }
+    Bench_report("scanner workload: untyped Vec_get/Vec_set", length * ROUNDS, Bench_now() - start);
+}
+
+static void scanner_typed(const Str *corpus)
+{
+    const char *input = Str_cstr(corpus);
+    size_t length = Str_length(corpus);
+    double start = Bench_now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        Vec lexeme = Vec_value(1, sizeof(char));
+        for (size_t i = 0; i < length; ++i) {
+            if (input[i] == ' ' || input[i] == '\n') {
+                if (Vec_length(&lexeme) > 0) {
+                    sink += CharVec_load(&lexeme, Vec_length(&lexeme) - 1);
+                }
+                Vec_truncate(&lexeme, 0);
+            } else {
+                CharVec_append(&lexeme, input[i]);
+            }
+        }
+        Vec_drop(&lexeme);
+    }
+    Bench_report("scanner workload: typed CharVec", length * ROUNDS, Bench_now() - start);
+}
+
+#define WORDS (1024 * 1024)
+
+static void parser_untyped(void)
+{
+    double start = Bench_now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        Vec words = Vec_value(1, sizeof(Str));
+        Str word = Str_value(0);
+        for (size_t i = 0; i < WORDS; ++i) {
+            Vec_set(&words, Vec_length(&words), &word);
+        }
+        for (size_t i = 0; i < WORDS; ++i) {
+            Str out;
+            Vec_get(&words, i, &out);
+            sink += out.length;
+        }
+        Vec_drop(&words);
+        Str_drop(&word);
+    }
+    Bench_report("parser workload: untyped Vec_get/Vec_set", WORDS * ROUNDS * sizeof(Str),
+            Bench_now() - start);
+}
+
+static void parser_typed(void)
+{
+    double start = Bench_now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        Vec words = Vec_value(1, sizeof(Str));
+        Str word = Str_value(0);
+        for (size_t i = 0; i < WORDS; ++i) {
+            StrVec_append(&words, word);
+        }
+        for (size_t i = 0; i < WORDS; ++i) {
+            sink += StrVec_load(&words, i).length;
+        }
+        Vec_drop(&words);
+        Str_drop(&word);
+    }
+    Bench_report("parser workload: typed StrVec", WORDS * ROUNDS * sizeof(Str),
+            Bench_now() - start);
+}
+
+static void scan_and_parse(const Str *corpus)
+{
+    const char *cursor = Str_cstr(corpus);
+    const char *end = cursor + Str_length(corpus);
+    double start = Bench_now();
+    while (cursor < end) {
+        const char *newline = memchr(cursor, '\n', end - cursor);
+        size_t length = (newline != NULL ? newline + 1 : end) - cursor;
+        Scanner scanner = Scanner_value(CharItr_value(cursor, length));
+        Node *node = parse(&scanner);
+        Node_drop(node);
+        cursor += length;
+    }
+    Bench_report("end-to-end scan + parse", Str_length(corpus), Bench_now() - start);
+}
+
+int main()
+{
+    Str corpus = Str_value(CORPUS_BYTES);
+    Bench_corpus(&corpus, CORPUS_BYTES);
+
+    printf("=== VecBench ===\n");
+    scanner_untyped(&corpus);
+    scanner_typed(&corpus);
+    parser_untyped();
+    parser_typed();
+    scan_and_parse(&corpus);
+
+    Str_drop(&corpus);
+    return EXIT_SUCCESS;
+}
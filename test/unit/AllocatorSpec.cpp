@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+
+#include <string>
+
+extern "C" {
+#include "Allocator.h"
+#include "Vec.h"
+#include "Str.h"
+#include "StrVec.h"
+#include "Parser.h"
+#include "Atom.h"
+}
+
+/**
+ * A counting Allocator forwarding to the system allocator, used to
+ * prove allocations are routed through the configured Allocator.
+ */
+
+typedef struct Counts {
+    size_t allocs;
+    size_t reallocs;
+    size_t frees;
+} Counts;
+
+static void* counting_alloc(void *user, size_t size)
+{
+    ((Counts*) user)->allocs++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void *user, void *ptr, size_t old_size, size_t new_size)
+{
+    ((Counts*) user)->reallocs++;
+    return realloc(ptr, new_size);
+}
+
+static void counting_free(void *user, void *ptr, size_t size)
+{
+    ((Counts*) user)->frees++;
+    free(ptr);
+}
+
+static Allocator counting_allocator(Counts *counts)
+{
+    Allocator allocator = {
+        counting_alloc,
+        counting_realloc,
+        counting_free,
+        counts
+    };
+    return allocator;
+}
+
+TEST(AllocatorSpec, default_is_system)
+{
+    ASSERT_EQ(Allocator_system(), Allocator_default());
+}
+
+TEST(AllocatorSpec, vec_value_in)
+{
+    Counts counts = {0, 0, 0};
+    Allocator allocator = counting_allocator(&counts);
+
+    Vec v = Vec_value_in(1, sizeof(int), &allocator);
+    ASSERT_EQ(1, counts.allocs);
+    int items[] = {1, 2, 3, 4};
+    Vec_extend(&v, items, 4);
+    ASSERT_EQ(1, counts.reallocs);
+    Vec_drop(&v);
+    ASSERT_EQ(1, counts.frees);
+}
+
+TEST(AllocatorSpec, inline_spill_uses_allocator)
+{
+    Counts counts = {0, 0, 0};
+    Allocator allocator = counting_allocator(&counts);
+    Allocator_set_default(&allocator);
+
+    Str s = Str_inline();
+    Str_append(&s, "short");
+    ASSERT_EQ(0, counts.allocs);
+    Str_append(&s, " and then something much longer");
+    ASSERT_EQ(1, counts.allocs);
+    Str_drop(&s);
+    ASSERT_EQ(1, counts.frees);
+
+    Allocator_set_default(NULL);
+    ASSERT_EQ(Allocator_system(), Allocator_default());
+}
+
+TEST(AllocatorSpec, default_routes_parse_tree)
+{
+    Counts counts = {0, 0, 0};
+    Allocator allocator = counting_allocator(&counts);
+    Allocator_set_default(&allocator);
+
+    Str input = Str_from("ls -lah | grep foo");
+    Scanner scanner = Scanner_value(CharItr_of_Str(&input));
+    Node *ast = parse(&scanner);
+    Node_drop(ast);
+    Str_drop(&input);
+
+    Allocator_set_default(NULL);
+
+    ASSERT_GT(counts.allocs, 0);
+    ASSERT_EQ(counts.allocs, counts.frees);
+}
+
+TEST(AllocatorSpec, default_routes_atoms)
+{
+    // Start from an empty table, so that it is allocated below too
+    Atom_release_all();
+    Counts counts = {0, 0, 0};
+    Allocator allocator = counting_allocator(&counts);
+    Allocator_set_default(&allocator);
+
+    Atom_intern_cstr("sort");
+    size_t allocs = counts.allocs;
+    // An Atom larger than a chunk is given a chunk of its own
+    std::string large(8192, 'x');
+    Atom_intern(large.data(), large.size());
+    Allocator_set_default(NULL);
+
+    ASSERT_EQ(allocs + 1, counts.allocs);
+    Atom_release_all();
+    ASSERT_EQ(counts.allocs, counts.frees);
+}
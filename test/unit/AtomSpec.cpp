@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+extern "C" {
+#include "Atom.h"
+#include "Map.h"
+}
+
+/**
+ * Contract tests for the global Atom interning table.
+ */
+
+TEST(AtomSpec, intern_is_stable) {
+    const Atom *a = Atom_intern_cstr("grep");
+    const Atom *b = Atom_intern("grep -v", 4);
+    ASSERT_EQ(a, b);
+    ASSERT_STREQ("grep", Atom_cstr(a));
+    ASSERT_EQ(4, a->length);
+    ASSERT_EQ(Map_hash_bytes("grep", 4), a->hash);
+}
+
+TEST(AtomSpec, distinct_chars_distinct_atoms) {
+    const Atom *a = Atom_intern_cstr("sort");
+    const Atom *b = Atom_intern_cstr("sorted");
+    const Atom *empty = Atom_intern_cstr("");
+    ASSERT_NE(a, b);
+    ASSERT_NE(a, empty);
+    ASSERT_EQ(0, empty->length);
+    ASSERT_STREQ("", Atom_cstr(empty));
+}
+
+TEST(AtomSpec, intern_view) {
+    StrView view = StrView_from_cstr("uniq -c");
+    StrView word = StrView_slice(&view, 0, 4);
+    const Atom *atom = Atom_intern_view(&word);
+    StrView back = Atom_view(atom);
+    ASSERT_TRUE(StrView_equals(&word, &back));
+    ASSERT_EQ(atom, Atom_intern_cstr("uniq"));
+}
+
+TEST(AtomSpec, find_never_inserts) {
+    size_t count = Atom_count();
+    ASSERT_EQ(NULL, Atom_find("never-interned", 14));
+    ASSERT_EQ(count, Atom_count());
+    const Atom *atom = Atom_intern_cstr("now-interned");
+    ASSERT_EQ(atom, Atom_find("now-interned", 12));
+    ASSERT_EQ(count + 1, Atom_count());
+}
+
+TEST(AtomSpec, many_and_large_atoms) {
+    char word[16];
+    const Atom *atoms[2000];
+    for (int i = 0; i < 2000; ++i) {
+        snprintf(word, sizeof(word), "w%d", i);
+        atoms[i] = Atom_intern_cstr(word);
+    }
+    char big[10000];
+    memset(big, 'x', sizeof(big));
+    const Atom *large = Atom_intern(big, sizeof(big));
+    for (int i = 0; i < 2000; ++i) {
+        snprintf(word, sizeof(word), "w%d", i);
+        ASSERT_EQ(atoms[i], Atom_intern_cstr(word));
+        ASSERT_STREQ(word, Atom_cstr(atoms[i]));
+    }
+    ASSERT_EQ(large, Atom_intern(big, sizeof(big)));
+    ASSERT_EQ(sizeof(big), strlen(Atom_cstr(large)));
+}
+
+TEST(AtomSpec, release_all) {
+    Atom_intern_cstr("ls");
+    Atom_release_all();
+    ASSERT_EQ(0, Atom_count());
+    ASSERT_EQ(NULL, Atom_find("ls", 2));
+    ASSERT_STREQ("ls", Atom_cstr(Atom_intern_cstr("ls")));
+    ASSERT_EQ(1, Atom_count());
+}
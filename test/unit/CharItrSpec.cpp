@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+extern "C" {
+#include "CharItr.h"
+}
+
+static const CharSet SPACES = CharSet_value(" \t", 2);
+static const CharSet DELIMITERS = CharSet_value(" \t|", 3);
+
+TEST(CharItrSpec, skip_while) {
+    CharItr itr = CharItr_value(" \t  ls", 6);
+    StrView skipped = CharItr_skip_while(&itr, &SPACES);
+    ASSERT_EQ(4, skipped.length);
+    ASSERT_EQ('l', CharItr_peek(&itr));
+
+    StrView none = CharItr_skip_while(&itr, &SPACES);
+    ASSERT_EQ(0, none.length);
+}
+
+TEST(CharItrSpec, take_until) {
+    CharItr itr = CharItr_value("grep|wc", 7);
+    StrView grep = CharItr_take_until(&itr, &DELIMITERS);
+    ASSERT_TRUE(StrView_equals_cstr(&grep, "grep"));
+    ASSERT_EQ('|', CharItr_next(&itr));
+
+    StrView wc = CharItr_take_until(&itr, &DELIMITERS);
+    ASSERT_TRUE(StrView_equals_cstr(&wc, "wc"));
+    ASSERT_FALSE(CharItr_has_next(&itr));
+}
+
+TEST(CharItrSpec, take_until_long_run) {
+    char bytes[200];
+    memset(bytes, 'x', sizeof(bytes));
+    bytes[150] = '|';
+    CharItr itr = CharItr_value(bytes, sizeof(bytes));
+    StrView run = CharItr_take_until(&itr, &DELIMITERS);
+    ASSERT_EQ(bytes, run.start);
+    ASSERT_EQ(150, run.length);
+}
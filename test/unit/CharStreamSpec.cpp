@@ -0,0 +1,213 @@
+#include "gtest/gtest.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+extern "C" {
+#include "CharStream.h"
+#include "Scanner.h"
+}
+
+/**
+ * Streams are fed through a pipe whose write end is filled and closed
+ * up front, so reads see the input arrive in chunks.
+ */
+
+static int pipe_of(const char *cstr)
+{
+    int fds[2];
+    EXPECT_EQ(0, pipe(fds));
+    size_t length = strlen(cstr);
+    EXPECT_EQ((ssize_t) length, write(fds[1], cstr, length));
+    close(fds[1]);
+    return fds[0];
+}
+
+TEST(CharStreamSpec, iterates_all_chars) {
+    int fd = pipe_of("the quick brown fox");
+    CharStream stream = CharStream_value(fd, 4);
+    CharItr itr = CharItr_of_stream(&stream);
+    Str read = Str_value(0);
+    while (CharItr_has_next(&itr)) {
+        Str_set(&read, Str_length(&read), CharItr_next(&itr));
+    }
+    ASSERT_STREQ("the quick brown fox", Str_cstr(&read));
+    ASSERT_LE(Vec_capacity(&stream.buffer), 4);
+    Str_drop(&read);
+    CharStream_drop(&stream);
+    close(fd);
+}
+
+TEST(CharStreamSpec, empty_input) {
+    int fd = pipe_of("");
+    CharStream stream = CharStream_value(fd, 4);
+    CharItr itr = CharItr_of_stream(&stream);
+    ASSERT_FALSE(CharItr_has_next(&itr));
+    ASSERT_FALSE(CharItr_refill(&itr, NULL));
+    ASSERT_EQ(0, CharStream_error(&stream));
+    CharStream_drop(&stream);
+    close(fd);
+}
+
+TEST(CharStreamSpec, read_error_is_reported) {
+    // Reading a directory fails with EISDIR
+    int fd = open("/", O_RDONLY);
+    ASSERT_GE(fd, 0);
+    CharStream stream = CharStream_value(fd, 4);
+    CharItr itr = CharItr_of_stream(&stream);
+    ASSERT_FALSE(CharItr_has_next(&itr));
+    ASSERT_EQ(EISDIR, CharStream_error(&stream));
+    CharStream_drop(&stream);
+    close(fd);
+}
+
+TEST(CharStreamSpec, refill_keeps_mark) {
+    int fd = pipe_of("abcdefghij");
+    CharStream stream = CharStream_value(fd, 4);
+    CharItr itr = CharItr_of_stream(&stream);
+    ASSERT_TRUE(CharItr_has_next(&itr));
+    const char *mark = CharItr_cursor(&itr);
+    while (itr.cursor < itr.sentinel || CharItr_refill(&itr, &mark)) {
+        CharItr_next(&itr);
+    }
+    // The whole input was kept from the mark, growing the buffer
+    ASSERT_EQ(10, CharItr_cursor(&itr) - mark);
+    ASSERT_EQ(0, strncmp("abcdefghij", mark, 10));
+    CharStream_drop(&stream);
+    close(fd);
+}
+
+TEST(CharStreamSpec, in_memory_itr_never_refills) {
+    CharItr itr = CharItr_value("ab", 2);
+    ASSERT_FALSE(CharItr_refill(&itr, NULL));
+}
+
+TEST(CharStreamSpec, scanner_lines_across_chunks) {
+    int fd = pipe_of("grep -v foo   | sort\n\nwc --lines\n");
+    CharStream stream = CharStream_value(fd, 3);
+    Scanner scanner = Scanner_value(CharItr_of_stream(&stream));
+
+    const char *first[] = { "grep", "-v", "foo", "|", "sort" };
+    for (size_t i = 0; i < 5; ++i) {
+        Token token = Scanner_next(&scanner);
+        StrView lexeme = Token_view(&token);
+        ASSERT_TRUE(StrView_equals_cstr(&lexeme, first[i]));
+    }
+    ASSERT_FALSE(Scanner_has_next(&scanner));
+
+    ASSERT_TRUE(Scanner_next_line(&scanner));
+    ASSERT_FALSE(Scanner_has_next(&scanner));
+
+    ASSERT_TRUE(Scanner_next_line(&scanner));
+    // A streamed Token expires with the next call, so keep a copy
+    Token wc = Scanner_next(&scanner);
+    Str wc_copy = Token_to_Str(&wc);
+    Token lines = Scanner_next(&scanner);
+    StrView lines_view = Token_view(&lines);
+    ASSERT_STREQ("wc", Str_cstr(&wc_copy));
+    ASSERT_TRUE(StrView_equals_cstr(&lines_view, "--lines"));
+    Str_drop(&wc_copy);
+
+    ASSERT_FALSE(Scanner_next_line(&scanner));
+    CharStream_drop(&stream);
+    close(fd);
+}
+
+TEST(CharStreamSpec, bulk_spans_cross_refills) {
+    int fd = pipe_of("      a-very-long-word|xyz");
+    CharStream stream = CharStream_value(fd, 4);
+    CharItr itr = CharItr_of_stream(&stream);
+    CharSet spaces = CharSet_value(" ", 1);
+    CharSet pipe = CharSet_value("|", 1);
+
+    StrView skipped = CharItr_skip_while(&itr, &spaces);
+    ASSERT_EQ(6, skipped.length);
+    StrView word = CharItr_take_until(&itr, &pipe);
+    ASSERT_TRUE(StrView_equals_cstr(&word, "a-very-long-word"));
+    ASSERT_EQ('|', CharItr_next(&itr));
+    StrView rest = CharItr_take_until(&itr, &pipe);
+    ASSERT_TRUE(StrView_equals_cstr(&rest, "xyz"));
+    ASSERT_FALSE(CharItr_has_next(&itr));
+    CharStream_drop(&stream);
+    close(fd);
+}
+
+TEST(CharStreamSpec, scanner_fill_within_buffer) {
+    int fd = pipe_of("ls -l | wc\nsort -r -u");
+    CharStream stream = CharStream_value(fd, 64);
+    Scanner scanner = Scanner_value(CharItr_of_stream(&stream));
+    Token tokens[8];
+
+    // The first line's newline is buffered, so its tokens come at once
+    ASSERT_EQ(4, Scanner_fill(&scanner, tokens, 8));
+    StrView wc = Token_view(&tokens[3]);
+    ASSERT_TRUE(StrView_equals_cstr(&wc, "wc"));
+
+    // Without a buffered newline, a refill could move earlier tokens
+    ASSERT_TRUE(Scanner_next_line(&scanner));
+    ASSERT_EQ(1, Scanner_fill(&scanner, tokens, 8));
+    StrView sort = Token_view(&tokens[0]);
+    ASSERT_TRUE(StrView_equals_cstr(&sort, "sort"));
+
+    CharStream_drop(&stream);
+    close(fd);
+}
+
+TEST(CharStreamSpec, scanner_fill_long_line) {
+    // A line many chunks long, whose newline arrives with its last chunk
+    std::string line;
+    for (int i = 0; i < 200; ++i) {
+        line += "w" + std::to_string(i) + " ";
+    }
+    line += "\nnext";
+    int fd = pipe_of(line.c_str());
+    CharStream stream = CharStream_value(fd, 32);
+    Scanner scanner = Scanner_value(CharItr_of_stream(&stream));
+    Token tokens[8];
+
+    int words = 0;
+    size_t count;
+    while ((count = Scanner_fill(&scanner, tokens, 8)) > 0) {
+        for (size_t i = 0; i < count; ++i, ++words) {
+            std::string expected = "w" + std::to_string(words);
+            StrView word = Token_view(&tokens[i]);
+            ASSERT_TRUE(StrView_equals_cstr(&word, expected.c_str()));
+        }
+    }
+    ASSERT_EQ(200, words);
+
+    ASSERT_TRUE(Scanner_next_line(&scanner));
+    ASSERT_EQ(1, Scanner_fill(&scanner, tokens, 8));
+    StrView next = Token_view(&tokens[0]);
+    ASSERT_TRUE(StrView_equals_cstr(&next, "next"));
+
+    CharStream_drop(&stream);
+    close(fd);
+}
+
+TEST(CharStreamSpec, scanner_long_word_across_chunks) {
+    // Long words skip to their end by kernel, refilling as they go
+    std::string word(100, 'w');
+    std::string line = word + "|" + word + "x'q'\n";
+    int fd = pipe_of(line.c_str());
+    CharStream stream = CharStream_value(fd, 8);
+    Scanner scanner = Scanner_value(CharItr_of_stream(&stream));
+
+    Token token = Scanner_next(&scanner);
+    ASSERT_EQ(WORD_TOKEN, token.type);
+    ASSERT_EQ(100, token.length);
+    ASSERT_EQ(0, strncmp(word.c_str(), token.start, 100));
+    ASSERT_EQ(PIPE_TOKEN, Scanner_next(&scanner).type);
+    token = Scanner_next(&scanner);
+    ASSERT_TRUE(token.quoted);
+    Str unquoted = Token_to_Str(&token);
+    ASSERT_EQ(word + "xq", std::string(Str_cstr(&unquoted)));
+    Str_drop(&unquoted);
+    ASSERT_FALSE(Scanner_has_next(&scanner));
+
+    CharStream_drop(&stream);
+    close(fd);
+}
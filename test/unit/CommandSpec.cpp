@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+extern "C" {
+#include "Command.h"
+}
+
+/**
+ * Contract tests for the packed, argv-ready Command representation.
+ */
+
+TEST(CommandSpec, empty) {
+    Command c = Command_value();
+    ASSERT_EQ(0, Command_length(&c));
+    ASSERT_EQ(NULL, Command_argv(&c)[0]);
+    Command_drop(&c);
+}
+
+TEST(CommandSpec, push_words) {
+    Command c = Command_value();
+    Command_push(&c, "grep -v", 4, NULL);
+    Command_push(&c, "-v", 2, NULL);
+    ASSERT_EQ(2, Command_length(&c));
+    ASSERT_STREQ("grep", Command_word(&c, 0));
+    ASSERT_STREQ("-v", Command_word(&c, 1));
+
+    char* const* argv = Command_argv(&c);
+    ASSERT_STREQ("grep", argv[0]);
+    ASSERT_STREQ("-v", argv[1]);
+    ASSERT_EQ(NULL, argv[2]);
+    Command_drop(&c);
+}
+
+TEST(CommandSpec, words_are_packed) {
+    Command c = Command_value();
+    Command_push(&c, "ls", 2, NULL);
+    Command_push(&c, "-l", 2, NULL);
+    ASSERT_EQ(Command_word(&c, 0) + 3, Command_word(&c, 1));
+    Command_drop(&c);
+}
+
+TEST(CommandSpec, argv_follows_growth) {
+    Command c = Command_value();
+    char word[16];
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(word, sizeof(word), "arg%d", i);
+        Command_push(&c, word, strlen(word), NULL);
+    }
+    char* const* argv = Command_argv(&c);
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(word, sizeof(word), "arg%d", i);
+        ASSERT_STREQ(word, argv[i]);
+    }
+    ASSERT_EQ(NULL, argv[1000]);
+    Command_drop(&c);
+}
+
+TEST(CommandSpec, atoms) {
+    Command c = Command_value();
+    const Atom *sort = Atom_intern_cstr("sort");
+    Command_push(&c, "sort", 4, sort);
+    ASSERT_EQ(sort, Command_atom(&c, 0));
+    Command_drop(&c);
+}
+
+TEST(CommandSpec, word_out_of_bounds) {
+    Command c = Command_value();
+    Command_push(&c, "ls", 2, NULL);
+    ASSERT_EXIT(Command_word(&c, 1), ::testing::ExitedWithCode(EXIT_FAILURE), ".* - Out of Bounds");
+    ASSERT_EXIT(Command_atom(&c, 1), ::testing::ExitedWithCode(EXIT_FAILURE), ".* - Out of Bounds");
+    Command_drop(&c);
+}
+
+TEST(CommandSpec, clear_keeps_buffers) {
+    Command c = Command_value();
+    Command_push(&c, "sort", 4, Atom_intern_cstr("sort"));
+    Command_push(&c, "-u", 2, NULL);
+    const char *chars = Command_word(&c, 0);
+    Command_clear(&c);
+    ASSERT_EQ(0, Command_length(&c));
+    ASSERT_EQ(NULL, Command_argv(&c)[0]);
+
+    Command_push(&c, "uniq", 4, NULL);
+    ASSERT_EQ(chars, Command_word(&c, 0));
+    ASSERT_EQ(NULL, Command_atom(&c, 0));
+    ASSERT_EQ(NULL, Command_argv(&c)[1]);
+    Command_drop(&c);
+}
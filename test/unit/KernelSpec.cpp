@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+extern "C" {
+#include "Kernels.h"
+}
+
+/**
+ * Every kernel level available on this CPU must agree with the scalar
+ * kernels, including across block boundaries and unaligned starts.
+ */
+
+static const CharSet WORD_DELIMITERS = CharSet_value(" \t\n|\0", 5);
+
+class KernelSpec : public ::testing::TestWithParam<KernelLevel> {
+protected:
+    KernelLevel previous;
+
+    void SetUp() override {
+        previous = Kernel_level();
+        if (Kernel_set_level(GetParam()) != GetParam()) {
+            Kernel_set_level(previous);
+            GTEST_SKIP() << "kernel level not supported by this CPU";
+        }
+    }
+
+    void TearDown() override {
+        Kernel_set_level(previous);
+    }
+};
+
+TEST_P(KernelSpec, length) {
+    char buffer[160];
+    for (size_t offset = 0; offset < 32; ++offset) {
+        for (size_t length = 0; length < 100; ++length) {
+            memset(buffer, 'x', sizeof(buffer));
+            buffer[offset + length] = '\0';
+            ASSERT_EQ(length, Kernel_length(buffer + offset));
+        }
+    }
+}
+
+TEST_P(KernelSpec, find_any) {
+    char buffer[128];
+    memset(buffer, 'a', sizeof(buffer));
+    for (size_t offset = 0; offset < 32; ++offset) {
+        ASSERT_EQ(96, Kernel_find_any(buffer + offset, 96, &WORD_DELIMITERS));
+        for (size_t at = 0; at < 96; ++at) {
+            buffer[offset + at] = at % 2 ? '|' : '\0';
+            ASSERT_EQ(at, Kernel_find_any(buffer + offset, 96, &WORD_DELIMITERS));
+            buffer[offset + at] = 'a';
+        }
+    }
+}
+
+TEST_P(KernelSpec, find_any_empty_set) {
+    CharSet none = CharSet_value("", 0);
+    ASSERT_EQ(40, Kernel_find_any("0123456789012345678901234567890123456789", 40, &none));
+}
+
+TEST_P(KernelSpec, skip_while) {
+    char buffer[128];
+    memset(buffer, ' ', sizeof(buffer));
+    for (size_t offset = 0; offset < 32; ++offset) {
+        ASSERT_EQ(96, Kernel_skip_while(buffer + offset, 96, &WORD_DELIMITERS));
+        for (size_t at = 0; at < 96; ++at) {
+            buffer[offset + at] = 'w';
+            ASSERT_EQ(at, Kernel_skip_while(buffer + offset, 96, &WORD_DELIMITERS));
+            buffer[offset + at] = ' ';
+        }
+    }
+}
+
+TEST_P(KernelSpec, high_bytes) {
+    CharSet high = CharSet_value("\xff\x80", 2);
+    const char *bytes = "abcdefghijklmnopqrstuvwxyzabcdef\x80xyz";
+    ASSERT_EQ(32, Kernel_find_any(bytes, 36, &high));
+}
+
+TEST_P(KernelSpec, equals) {
+    char a[128], b[128];
+    for (size_t i = 0; i < sizeof(a); ++i) {
+        a[i] = b[i] = (char) i;
+    }
+    for (size_t length = 0; length <= sizeof(a); ++length) {
+        ASSERT_TRUE(Kernel_equals(a, b, length));
+    }
+    for (size_t at = 0; at < sizeof(a); ++at) {
+        b[at] ^= 1;
+        ASSERT_FALSE(Kernel_equals(a, b, sizeof(a)));
+        ASSERT_TRUE(Kernel_equals(a, b, at));
+        b[at] ^= 1;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Levels, KernelSpec,
+        ::testing::Values(KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2));
+
+TEST(CharSetSpec, too_many_chars) {
+    ASSERT_EXIT(CharSet_value("abcdefghijklmnopq", 17), ::testing::ExitedWithCode(EXIT_FAILURE), ".* - Out of Bounds");
+}
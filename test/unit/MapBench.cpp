@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+extern "C" {
+#include "stdint.h"
+#include "Map.h"
+#include "Str.h"
+}
+
+/**
+ * Benchmarks of Map insertion and lookup, both for fixed size integer
+ * keys and for Str keys looked up by the bytes of a word. Each prints
+ * its rate and checks what it looked up, so they run with the rest of
+ * the unit tests. Compare a release build's rates, not a debug build's.
+ */
+
+#define ENTRIES (256 * 1024)
+
+static uint64_t size_hash(const void *key)
+{
+    return Map_hash_bytes(key, sizeof(size_t));
+}
+
+static bool size_equals(const void *key, const void *other)
+{
+    return *(const size_t*) key == *(const size_t*) other;
+}
+
+static double now(void)
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+/* Print a rate line in millions of operations per second. */
+static void report_ops(const char *name, size_t ops, double seconds)
+{
+    printf("%-44s %10.2f Mop/s %9.3f s\n", name, (double) ops / seconds / 1e6, seconds);
+}
+
+TEST(MapBench, size_t_keys) {
+    Map m = Map_value(sizeof(size_t), sizeof(size_t), size_hash, size_equals, NULL);
+
+    double start = now();
+    for (size_t i = 0; i < ENTRIES; ++i) {
+        Map_set(&m, &i, &i);
+    }
+    report_ops("Map_set: size_t keys", ENTRIES, now() - start);
+    ASSERT_EQ(ENTRIES, Map_length(&m));
+
+    size_t hits = 0;
+    start = now();
+    for (size_t i = 0; i < ENTRIES; ++i) {
+        hits += *(size_t*) Map_get(&m, &i) == i;
+    }
+    report_ops("Map_get hit: size_t keys", ENTRIES, now() - start);
+    ASSERT_EQ(ENTRIES, hits);
+
+    size_t misses = 0;
+    start = now();
+    for (size_t i = ENTRIES; i < 2 * ENTRIES; ++i) {
+        misses += Map_get(&m, &i) == NULL;
+    }
+    report_ops("Map_get miss: size_t keys", ENTRIES, now() - start);
+    ASSERT_EQ(ENTRIES, misses);
+
+    Map_drop(&m);
+}
+
+TEST(MapBench, str_keys) {
+    static const char *words[] = {
+        "ls", "-l", "-lah", "grep", "-v", "-E", "sort", "uniq", "-c",
+        "cat", "tail", "-n", "find", "-name", "echo", "tr", "less", "git",
+    };
+    size_t count = sizeof(words) / sizeof(words[0]);
+    size_t lengths[sizeof(words) / sizeof(words[0])];
+
+    Map m = Map_str_value(sizeof(size_t));
+    for (size_t i = 0; i < count; ++i) {
+        Str key = Str_from(words[i]);
+        Map_set(&m, &key, &i);
+        lengths[i] = strlen(words[i]);
+    }
+
+    size_t hits = 0;
+    double start = now();
+    for (size_t i = 0; i < ENTRIES; ++i) {
+        size_t w = i % count;
+        hits += *(size_t*) Map_get_str(&m, words[w], lengths[w]) == w;
+    }
+    report_ops("Map_get_str hit: shell words", ENTRIES, now() - start);
+    ASSERT_EQ(ENTRIES, hits);
+
+    Map_drop(&m);
+}
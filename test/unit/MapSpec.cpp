@@ -0,0 +1,186 @@
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "stdint.h"
+#include "Map.h"
+#include "Str.h"
+}
+
+/**
+ * The purpose of these tests is to prove correctness of the Map
+ * abstraction barrier from the user's point-of-view.
+ */
+
+static uint64_t int_hash(const void *key)
+{
+    return Map_hash_bytes(key, sizeof(int));
+}
+
+static bool int_equals(const void *key, const void *other)
+{
+    return *(const int*) key == *(const int*) other;
+}
+
+/* A deliberately terrible hash to force long probe sequences */
+static uint64_t collide_hash(const void *key)
+{
+    return 42;
+}
+
+static Map int_map(void)
+{
+    return Map_value(sizeof(int), sizeof(int), int_hash, int_equals, NULL);
+}
+
+TEST(MapSpec, value_empty) {
+    Map m = int_map();
+    int key = 1;
+    ASSERT_EQ(0, Map_length(&m));
+    ASSERT_EQ(nullptr, Map_get(&m, &key));
+    Map_drop(&m);
+}
+
+TEST(MapSpec, set_get_contract) {
+    Map m = int_map();
+    int key = 7;
+    int value = 700;
+    Map_set(&m, &key, &value);
+    ASSERT_EQ(1, Map_length(&m));
+    ASSERT_EQ(700, *(int*) Map_get(&m, &key));
+
+    int missing = 8;
+    ASSERT_EQ(nullptr, Map_get(&m, &missing));
+    Map_drop(&m);
+}
+
+TEST(MapSpec, set_overwrites) {
+    Map m = int_map();
+    int key = 7;
+    int value = 700;
+    Map_set(&m, &key, &value);
+    value = 701;
+    Map_set(&m, &key, &value);
+    ASSERT_EQ(1, Map_length(&m));
+    ASSERT_EQ(701, *(int*) Map_get(&m, &key));
+    Map_drop(&m);
+}
+
+TEST(MapSpec, many_entries_grow) {
+    Map m = int_map();
+    for (int i = 0; i < 10000; ++i) {
+        int value = i * 2;
+        Map_set(&m, &i, &value);
+    }
+    ASSERT_EQ(10000, Map_length(&m));
+    for (int i = 0; i < 10000; ++i) {
+        int *value = (int*) Map_get(&m, &i);
+        ASSERT_NE(nullptr, value);
+        ASSERT_EQ(i * 2, *value);
+    }
+    Map_drop(&m);
+}
+
+TEST(MapSpec, remove_contract) {
+    Map m = int_map();
+    for (int i = 0; i < 100; ++i) {
+        Map_set(&m, &i, &i);
+    }
+    for (int i = 0; i < 100; i += 2) {
+        int out = -1;
+        ASSERT_TRUE(Map_remove(&m, &i, &out));
+        ASSERT_EQ(i, out);
+    }
+    ASSERT_EQ(50, Map_length(&m));
+    for (int i = 0; i < 100; ++i) {
+        if (i % 2 == 0) {
+            ASSERT_EQ(nullptr, Map_get(&m, &i));
+        } else {
+            ASSERT_EQ(i, *(int*) Map_get(&m, &i));
+        }
+    }
+    int missing = 0;
+    ASSERT_FALSE(Map_remove(&m, &missing, NULL));
+    Map_drop(&m);
+}
+
+TEST(MapSpec, churn_reuses_tombstones) {
+    Map m = int_map();
+    for (int round = 0; round < 1000; ++round) {
+        Map_set(&m, &round, &round);
+        ASSERT_TRUE(Map_remove(&m, &round, NULL));
+    }
+    ASSERT_EQ(0, Map_length(&m));
+    int key = 999;
+    ASSERT_EQ(nullptr, Map_get(&m, &key));
+    Map_drop(&m);
+}
+
+TEST(MapSpec, collisions) {
+    Map m = Map_value(sizeof(int), sizeof(int), collide_hash, int_equals, NULL);
+    for (int i = 0; i < 100; ++i) {
+        Map_set(&m, &i, &i);
+    }
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(i, *(int*) Map_get(&m, &i));
+    }
+    for (int i = 0; i < 100; i += 3) {
+        ASSERT_TRUE(Map_remove(&m, &i, NULL));
+    }
+    for (int i = 1; i < 100; i += 3) {
+        ASSERT_EQ(i, *(int*) Map_get(&m, &i));
+    }
+    Map_drop(&m);
+}
+
+TEST(MapSpec, next_visits_every_entry) {
+    Map m = int_map();
+    for (int i = 0; i < 50; ++i) {
+        Map_set(&m, &i, &i);
+    }
+    size_t cursor = 0;
+    void *key;
+    void *value;
+    int sum = 0;
+    size_t count = 0;
+    while (Map_next(&m, &cursor, &key, &value)) {
+        ASSERT_EQ(*(int*) key, *(int*) value);
+        sum += *(int*) key;
+        count++;
+    }
+    ASSERT_EQ(50, count);
+    ASSERT_EQ(49 * 50 / 2, sum);
+    Map_drop(&m);
+}
+
+TEST(MapSpec, str_keys) {
+    Map m = Map_str_value(sizeof(int));
+    const char *words[] = { "grep", "-v", "sort", "|", "a-much-longer-word-than-inline" };
+    for (int i = 0; i < 5; ++i) {
+        Str key = Str_from(words[i]);
+        Map_set(&m, &key, &i);
+    }
+    ASSERT_EQ(5, Map_length(&m));
+
+    // Setting an existing key drops the redundant key Str
+    Str duplicate = Str_from("grep");
+    int value = 10;
+    Map_set(&m, &duplicate, &value);
+    ASSERT_EQ(5, Map_length(&m));
+
+    ASSERT_EQ(10, *(int*) Map_get_str(&m, "grep", 4));
+    ASSERT_EQ(1, *(int*) Map_get_str(&m, "-v", 2));
+    ASSERT_EQ(4, *(int*) Map_get_str(&m, words[4], strlen(words[4])));
+    ASSERT_EQ(nullptr, Map_get_str(&m, "gre", 3));
+
+    Str probe = Str_from("sort");
+    ASSERT_EQ(2, *(int*) Map_get(&m, &probe));
+    Str_drop(&probe);
+
+    Map_drop(&m);
+}
+
+TEST(MapSpec, hash_bytes) {
+    ASSERT_EQ(Map_hash_bytes("hello world", 11), Map_hash_bytes("hello world", 11));
+    ASSERT_NE(Map_hash_bytes("hello world", 11), Map_hash_bytes("hello worle", 11));
+    ASSERT_NE(Map_hash_bytes("ab", 2), Map_hash_bytes("ab\0", 3));
+}
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+extern "C" {
+#include "MappedFile.h"
+#include "Scanner.h"
+}
+
+static void write_file(char *path, const char *cstr)
+{
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ((ssize_t) strlen(cstr), write(fd, cstr, strlen(cstr)));
+    close(fd);
+}
+
+TEST(MappedFileSpec, maps_contents) {
+    char path[] = "/tmp/thsh-mapped-XXXXXX";
+    write_file(path, "ls -l\nwc\n");
+    MappedFile file;
+    ASSERT_TRUE(MappedFile_open(path, &file));
+    ASSERT_EQ(9, file.length);
+    ASSERT_EQ(0, memcmp("ls -l\nwc\n", file.bytes, 9));
+
+    Scanner scanner = Scanner_value(CharItr_of_MappedFile(&file));
+    Token ls = Scanner_next(&scanner);
+    StrView ls_view = Token_view(&ls);
+    ASSERT_TRUE(StrView_equals_cstr(&ls_view, "ls"));
+    ASSERT_TRUE(Scanner_next_line(&scanner));
+    Token wc = Scanner_next(&scanner);
+    StrView wc_view = Token_view(&wc);
+    ASSERT_TRUE(StrView_equals_cstr(&wc_view, "wc"));
+    ASSERT_FALSE(Scanner_next_line(&scanner));
+
+    MappedFile_drop(&file);
+    unlink(path);
+}
+
+TEST(MappedFileSpec, empty_file) {
+    char path[] = "/tmp/thsh-mapped-XXXXXX";
+    write_file(path, "");
+    MappedFile file;
+    ASSERT_TRUE(MappedFile_open(path, &file));
+    ASSERT_EQ(0, file.length);
+    CharItr itr = CharItr_of_MappedFile(&file);
+    ASSERT_FALSE(CharItr_has_next(&itr));
+    MappedFile_drop(&file);
+    unlink(path);
+}
+
+TEST(MappedFileSpec, missing_file) {
+    MappedFile file;
+    ASSERT_FALSE(MappedFile_open("/nonexistent/thsh/script", &file));
+    ASSERT_EQ(ENOENT, errno);
+}
+
+TEST(MappedFileSpec, pipe_is_not_mapped) {
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ(3, write(fds[1], "ls\n", 3));
+    close(fds[1]);
+
+    // A pipe reports a size of 0, so mapping it would lose its input
+    MappedFile file;
+    ASSERT_FALSE(MappedFile_open_fd(fds[0], &file));
+    ASSERT_EQ(ENODEV, errno);
+    char read_back[4] = { 0 };
+    ASSERT_EQ(3, read(fds[0], read_back, sizeof(read_back)));
+    ASSERT_STREQ("ls\n", read_back);
+    close(fds[0]);
+}
+
+TEST(MappedFileSpec, open_fd_leaves_fd_open) {
+    char path[] = "/tmp/thsh-mapped-XXXXXX";
+    write_file(path, "wc\n");
+    int fd = open(path, O_RDONLY);
+    MappedFile file;
+    ASSERT_TRUE(MappedFile_open_fd(fd, &file));
+    ASSERT_EQ(3, file.length);
+    ASSERT_EQ(0, close(fd));
+    ASSERT_EQ(0, memcmp("wc\n", file.bytes, 3));
+    MappedFile_drop(&file);
+    unlink(path);
+}
@@ -1,13 +1,14 @@
 #include "gtest/gtest.h"
 
+#include <cstring>
+
 extern "C" {
 #include "Parser.h"
 }
 
 static Scanner fixture(const char *cstr)
 {
-    Str input = Str_from(cstr);
-    return Scanner_value(CharItr_of_Str(&input));
+    return Scanner_value(CharItr_value(cstr, strlen(cstr)));
 }
 
 TEST(ParserSpec, empty)
@@ -23,9 +24,9 @@ TEST(ParserSpec, simple_command)
     Scanner scanner = fixture("grep foo bar.txt");
     Node *ast = parse(&scanner);
     ASSERT_EQ(COMMAND_NODE, ast->type);
-    ASSERT_STREQ("grep", Str_cstr(StrVec_ref(&ast->data.command, 0)));
-    ASSERT_STREQ("foo", Str_cstr(StrVec_ref(&ast->data.command, 1)));
-    ASSERT_STREQ("bar.txt", Str_cstr(StrVec_ref(&ast->data.command, 2)));
+    ASSERT_STREQ("grep", Command_word(&ast->data.command, 0));
+    ASSERT_STREQ("foo", Command_word(&ast->data.command, 1));
+    ASSERT_STREQ("bar.txt", Command_word(&ast->data.command, 2));
     Node_drop(ast);
 }
 
@@ -38,13 +39,13 @@ TEST(ParserSpec, pipe_command)
 
     Node *lhs = ast->data.pipe.left;
     ASSERT_EQ(COMMAND_NODE, lhs->type);
-    ASSERT_STREQ("ls", Str_cstr(StrVec_ref(&lhs->data.command, 0)));
-    ASSERT_STREQ("-lah", Str_cstr(StrVec_ref(&lhs->data.command, 1)));
+    ASSERT_STREQ("ls", Command_word(&lhs->data.command, 0));
+    ASSERT_STREQ("-lah", Command_word(&lhs->data.command, 1));
 
     Node *rhs = ast->data.pipe.right;
     ASSERT_EQ(COMMAND_NODE, rhs->type);
-    ASSERT_STREQ("grep", Str_cstr(StrVec_ref(&rhs->data.command, 0)));
-    ASSERT_STREQ("foo", Str_cstr(StrVec_ref(&rhs->data.command, 1)));
+    ASSERT_STREQ("grep", Command_word(&rhs->data.command, 0));
+    ASSERT_STREQ("foo", Command_word(&rhs->data.command, 1));
 
     Node_drop(ast);
 }
@@ -58,22 +59,162 @@ TEST(ParserSpec, multiple_pipe_command)
 
     Node *lhs = ast->data.pipe.left;
     ASSERT_EQ(COMMAND_NODE, lhs->type);
-    ASSERT_STREQ("ls", Str_cstr(StrVec_ref(&lhs->data.command, 0)));
-    ASSERT_STREQ("-lah", Str_cstr(StrVec_ref(&lhs->data.command, 1)));
+    ASSERT_STREQ("ls", Command_word(&lhs->data.command, 0));
+    ASSERT_STREQ("-lah", Command_word(&lhs->data.command, 1));
 
     Node *rhs = ast->data.pipe.right;
     ASSERT_EQ(PIPE_NODE, rhs->type);
 
     Node *rhs_lhs = rhs->data.pipe.left;
     ASSERT_EQ(COMMAND_NODE, rhs_lhs->type);
-    ASSERT_STREQ("grep", Str_cstr(StrVec_ref(&rhs_lhs->data.command, 0)));
-    ASSERT_STREQ("-E", Str_cstr(StrVec_ref(&rhs_lhs->data.command, 1)));
-    ASSERT_STREQ("foo", Str_cstr(StrVec_ref(&rhs_lhs->data.command, 2)));
+    ASSERT_STREQ("grep", Command_word(&rhs_lhs->data.command, 0));
+    ASSERT_STREQ("-E", Command_word(&rhs_lhs->data.command, 1));
+    ASSERT_STREQ("foo", Command_word(&rhs_lhs->data.command, 2));
 
     Node *rhs_rhs = rhs->data.pipe.right;
     ASSERT_EQ(COMMAND_NODE, rhs_rhs->type);
-    ASSERT_STREQ("less", Str_cstr(StrVec_ref(&rhs_rhs->data.command, 0)));
+    ASSERT_STREQ("less", Command_word(&rhs_rhs->data.command, 0));
+
+    Node_drop(ast);
+}
+
+
+TEST(ParserSpec, interned_command)
+{
+    Str input = Str_from("sort -u | sort");
+    Scanner scanner = Scanner_interning(CharItr_of_Str(&input));
+    Node *ast = parse(&scanner);
+    ASSERT_EQ(PIPE_NODE, ast->type);
+
+    Command *lhs = &ast->data.pipe.left->data.command;
+    Command *rhs = &ast->data.pipe.right->data.command;
+    ASSERT_EQ(Atom_intern_cstr("-u"), Command_atom(lhs, 1));
+    ASSERT_EQ(Command_atom(lhs, 0), Command_atom(rhs, 0));
+    ASSERT_STREQ("sort", Atom_cstr(Command_atom(rhs, 0)));
+
+    Node_drop(ast);
+    Str_drop(&input);
+}
+
+TEST(ParserSpec, uninterned_command_has_no_atoms)
+{
+    Scanner scanner = fixture("sort -u");
+    Node *ast = parse(&scanner);
+    ASSERT_EQ(NULL, Command_atom(&ast->data.command, 0));
+    ASSERT_EQ(NULL, Command_atom(&ast->data.command, 1));
+    Node_drop(ast);
+}
+
+TEST(ParserSpec, recycle_reuses_command_buffers)
+{
+    Scanner scanner = fixture("ls -lah");
+    Node *ast = parse(&scanner);
+    const char *chars = Command_word(&ast->data.command, 0);
+    parse_recycle(ast);
+
+    scanner = fixture("grep foo");
+    ast = parse(&scanner);
+    ASSERT_EQ(chars, Command_word(&ast->data.command, 0));
+    ASSERT_STREQ("grep", Command_word(&ast->data.command, 0));
+    ASSERT_STREQ("foo", Command_word(&ast->data.command, 1));
+    ASSERT_EQ(2, Command_length(&ast->data.command));
+    Node_drop(ast);
+    parse_release();
+}
+
+TEST(ParserSpec, unsupported_operators_are_words)
+{
+    Scanner scanner = fixture("ls 2>&1 | wc");
+    Node *ast = parse(&scanner);
+    ASSERT_EQ(PIPE_NODE, ast->type);
+    Command *ls = &ast->data.pipe.left->data.command;
+    ASSERT_EQ(2, Command_length(ls));
+    ASSERT_STREQ("2>&1", Command_word(ls, 1));
+    ASSERT_STREQ("wc", Command_word(&ast->data.pipe.right->data.command, 0));
+    Node_drop(ast);
+
+    scanner = fixture("echo a>b && echo c");
+    ast = parse(&scanner);
+    ASSERT_EQ(COMMAND_NODE, ast->type);
+    const char *words[] = { "echo", "a", ">", "b", "&&", "echo", "c" };
+    ASSERT_EQ(7, Command_length(&ast->data.command));
+    for (size_t i = 0; i < 7; ++i) {
+        ASSERT_STREQ(words[i], Command_word(&ast->data.command, i));
+    }
+    Node_drop(ast);
+}
+
+TEST(ParserSpec, parse_tokens_from_array)
+{
+    Str input = Str_from("ls -lah | wc -l");
+    Scanner scanner = Scanner_value(CharItr_of_Str(&input));
+    Token tokens[8];
+    size_t count = Scanner_fill(&scanner, tokens, 8);
+    ASSERT_EQ(5, count);
+
+    Node *ast = parse_tokens(tokens, count);
+    ASSERT_EQ(PIPE_NODE, ast->type);
+    ASSERT_STREQ("-lah", Command_word(&ast->data.pipe.left->data.command, 1));
+    ASSERT_STREQ("wc", Command_word(&ast->data.pipe.right->data.command, 0));
+    Node_drop(ast);
+
+    // Only the first command's tokens
+    ast = parse_tokens(tokens, 2);
+    ASSERT_EQ(COMMAND_NODE, ast->type);
+    ASSERT_EQ(2, Command_length(&ast->data.command));
+    Node_drop(ast);
+    Str_drop(&input);
+}
 
+TEST(ParserSpec, parse_command_longer_than_batch)
+{
+    Str input = Str_value(0);
+    for (int i = 0; i < 200; ++i) {
+        Str_append(&input, i % 50 == 49 ? "w | " : "w ");
+    }
+    Str_append(&input, "end");
+    Scanner scanner = Scanner_value(CharItr_of_Str(&input));
+    Node *ast = parse(&scanner);
+    Node *node = ast;
+    size_t words = 0;
+    while (node->type == PIPE_NODE) {
+        words += Command_length(&node->data.pipe.left->data.command);
+        node = node->data.pipe.right;
+    }
+    words += Command_length(&node->data.command);
+    ASSERT_EQ(201, words);
     Node_drop(ast);
+    Str_drop(&input);
 }
 
+TEST(ParserSpec, quoted_words)
+{
+    Scanner scanner = fixture("grep 'foo bar' my\\ file.txt | wc");
+    Node *ast = parse(&scanner);
+    ASSERT_EQ(PIPE_NODE, ast->type);
+    Command *grep = &ast->data.pipe.left->data.command;
+    ASSERT_EQ(3, Command_length(grep));
+    ASSERT_STREQ("foo bar", Command_word(grep, 1));
+    ASSERT_STREQ("my file.txt", Command_word(grep, 2));
+    Node_drop(ast);
+}
+
+TEST(ParserSpec, recycle_drops_outlier_commands)
+{
+    Str huge = Str_value(0);
+    while (Str_length(&huge) <= PARSE_HIGH_WATER) {
+        Str_append(&huge, "--a-long-generated-flag ");
+    }
+    StrView huge_view = StrView_of_Str(&huge);
+    Node *ast = parse_view(&huge_view);
+    ASSERT_GT(Command_capacity(&ast->data.command), PARSE_HIGH_WATER);
+    parse_recycle(ast);
+
+    // The outlier's buffers were freed rather than handed to the next parse
+    StrView small = StrView_from_cstr("ls -l");
+    ast = parse_view(&small);
+    ASSERT_LE(Command_capacity(&ast->data.command), PARSE_HIGH_WATER);
+    Node_drop(ast);
+    parse_release();
+    Str_drop(&huge);
+}
@@ -1,5 +1,10 @@
 #include "gtest/gtest.h"
 
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
 extern "C" {
 #include "Scanner.h"
 }
@@ -8,35 +13,39 @@ extern "C" {
 
 static Scanner fixture(const char *cstr)
 {
-    Str input = Str_from(cstr);
-    return Scanner_value(CharItr_of_Str(&input));
+    return Scanner_value(CharItr_value(cstr, strlen(cstr)));
 }
 
-static Token Token_init(TokenType type, const char *cstr)
+typedef struct Expected {
+    TokenType type;
+    const char *lexeme;
+} Expected;
+
+static void ASSERT_TOKEN_EQ(Expected expect, Token actual)
 {
-    Token token = {
-        type,
-        Str_from(cstr)
-    };
-    return token;
+    Str lexeme = Token_to_Str(&actual);
+    std::string actual_lexeme(Str_cstr(&lexeme), Str_length(&lexeme));
+    Str_drop(&lexeme);
+    ASSERT_EQ(expect.type, actual.type);
+    ASSERT_EQ(std::string(expect.lexeme), actual_lexeme);
 }
 
 static void ASSERT_TOKEN_EQ(Token expect, Token actual)
 {
+    StrView expect_view = Token_view(&expect);
+    StrView actual_view = Token_view(&actual);
     ASSERT_EQ(expect.type, actual.type);
-    ASSERT_STREQ(Str_cstr(&expect.lexeme), Str_cstr(&actual.lexeme));
+    ASSERT_EQ(expect.quoted, actual.quoted);
+    ASSERT_EQ(std::string(expect_view.start, expect_view.length),
+              std::string(actual_view.start, actual_view.length));
 }
 
-static void ASSERT_TOKENS_EQ(Token expected[], size_t count, Scanner s)
+static void ASSERT_TOKENS_EQ(Expected expected[], size_t count, Scanner s)
 {
     for (size_t i = 0; i < count; ++i) {
         ASSERT_TRUE(Scanner_has_next(&s));
-        Token expect = expected[i];
-        ASSERT_TOKEN_EQ(expect, Scanner_peek(&s));
-        Token next = Scanner_next(&s);
-        ASSERT_TOKEN_EQ(expect, next);
-        Str_drop(&expect.lexeme);
-        Str_drop(&next.lexeme);
+        ASSERT_TOKEN_EQ(expected[i], Scanner_peek(&s));
+        ASSERT_TOKEN_EQ(expected[i], Scanner_next(&s));
     }
     ASSERT_FALSE(Scanner_has_next(&s));
 }
@@ -53,86 +62,493 @@ TEST(ScannerSpec, empty_string)
 TEST(ScannerSpec, single_word)
 {
     Scanner scanner = fixture("ls");
-    Token expected[] = {
-        { WORD_TOKEN, Str_from("ls") }
+    Expected expected[] = {
+        { WORD_TOKEN, "ls" }
     };
-    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Token), scanner);
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
 }
 
 TEST(ScannerSpec, single_word_special_chars)
 {
     Scanner scanner = fixture("hello-world-123");
-    Token expected[] = {
-        { WORD_TOKEN, Str_from("hello-world-123") }
+    Expected expected[] = {
+        { WORD_TOKEN, "hello-world-123" }
     };
-    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Token), scanner);
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
 }
 
 TEST(ScannerSpec, single_word_with_whitespace)
 {
     Scanner scanner = fixture(" \t ls  \t");
-    Token expected[] = {
-        { WORD_TOKEN, Str_from("ls") }
+    Expected expected[] = {
+        { WORD_TOKEN, "ls" }
     };
-    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Token), scanner);
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
 }
 
 TEST(ScannerSpec, two_words)
 {
     Scanner scanner = fixture("ls -lah");
-    Token expected[] = {
-        { WORD_TOKEN, Str_from("ls") },
-        { WORD_TOKEN, Str_from("-lah") },
+    Expected expected[] = {
+        { WORD_TOKEN, "ls" },
+        { WORD_TOKEN, "-lah" },
     };
-    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Token), scanner);
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
 }
 
 TEST(ScannerSpec, many_words)
 {
     Scanner scanner = fixture("the quick brown fox jumped over the fence");
-    Token expected[] = {
-        { WORD_TOKEN, Str_from("the") },
-        { WORD_TOKEN, Str_from("quick") },
-        { WORD_TOKEN, Str_from("brown") },
-        { WORD_TOKEN, Str_from("fox") },
-        { WORD_TOKEN, Str_from("jumped") },
-        { WORD_TOKEN, Str_from("over") },
-        { WORD_TOKEN, Str_from("the") },
-        { WORD_TOKEN, Str_from("fence") },
+    Expected expected[] = {
+        { WORD_TOKEN, "the" },
+        { WORD_TOKEN, "quick" },
+        { WORD_TOKEN, "brown" },
+        { WORD_TOKEN, "fox" },
+        { WORD_TOKEN, "jumped" },
+        { WORD_TOKEN, "over" },
+        { WORD_TOKEN, "the" },
+        { WORD_TOKEN, "fence" },
     };
-    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Token), scanner);
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
 }
 
 TEST(ScannerSpec, single_pipe)
 {
     Scanner scanner = fixture("|");
-    Token expected[] = {
-        { PIPE_TOKEN, Str_from("|") },
+    Expected expected[] = {
+        { PIPE_TOKEN, "|" },
     };
-    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Token), scanner);
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
 }
 
 TEST(ScannerSpec, whitespace_pipe)
 {
     Scanner scanner = fixture(" \t | \t ");
-    Token expected[] = {
-        { PIPE_TOKEN, Str_from("|") },
+    Expected expected[] = {
+        { PIPE_TOKEN, "|" },
     };
-    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Token), scanner);
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
 }
 
 TEST(ScannerSpec, many_words_and_pipes)
 {
     Scanner scanner = fixture("  \t the | \t quick \t \t brown | fox \t   | jumped   ");
-    Token expected[] = {
-        { WORD_TOKEN, Str_from("the") },
-        { PIPE_TOKEN, Str_from("|") },
-        { WORD_TOKEN, Str_from("quick") },
-        { WORD_TOKEN, Str_from("brown") },
-        { PIPE_TOKEN, Str_from("|") },
-        { WORD_TOKEN, Str_from("fox") },
-        { PIPE_TOKEN, Str_from("|") },
-        { WORD_TOKEN, Str_from("jumped") },
-    };
-    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Token), scanner);
+    Expected expected[] = {
+        { WORD_TOKEN, "the" },
+        { PIPE_TOKEN, "|" },
+        { WORD_TOKEN, "quick" },
+        { WORD_TOKEN, "brown" },
+        { PIPE_TOKEN, "|" },
+        { WORD_TOKEN, "fox" },
+        { PIPE_TOKEN, "|" },
+        { WORD_TOKEN, "jumped" },
+    };
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
+}
+
+TEST(ScannerSpec, interning_words)
+{
+    Str input = Str_from("grep foo | grep");
+    Scanner scanner = Scanner_interning(CharItr_of_Str(&input));
+    Token grep = Scanner_next(&scanner);
+    Token foo = Scanner_next(&scanner);
+    Token pipe = Scanner_next(&scanner);
+    Token grep_again = Scanner_next(&scanner);
+    ASSERT_EQ(Atom_intern_cstr("grep"), Token_atom(&grep));
+    ASSERT_EQ(Atom_intern_cstr("foo"), Token_atom(&foo));
+    ASSERT_EQ(NULL, Token_atom(&pipe));
+    ASSERT_EQ(Token_atom(&grep), Token_atom(&grep_again));
+    Str_drop(&input);
+
+    // Interned lexemes borrow the Atom's chars, so they outlive the input
+    ASSERT_EQ(Atom_cstr(Token_atom(&grep_again)), grep_again.start);
+    ASSERT_EQ(4, grep_again.length);
+}
+
+TEST(ScannerSpec, tokens_are_spans_of_input)
+{
+    Str input = Str_from("cat  notes.txt");
+    Scanner scanner = Scanner_value(CharItr_of_Str(&input));
+    Scanner_next(&scanner);
+    Token notes = Scanner_next(&scanner);
+    ASSERT_LE(sizeof(Token), 16);
+    ASSERT_EQ(Str_cstr(&input) + 5, notes.start);
+    ASSERT_EQ(9, notes.length);
+
+    Str copy = Token_to_Str(&notes);
+    Str_drop(&input);
+    ASSERT_STREQ("notes.txt", Str_cstr(&copy));
+    Str_drop(&copy);
+}
+
+TEST(ScannerSpec, reset_onto_new_input)
+{
+    Str first = Str_from("grep foo");
+    Str second = Str_from("wc | sort");
+    Scanner scanner = Scanner_interning(CharItr_of_Str(&first));
+    Scanner_next(&scanner);
+
+    // The rest of the first input is discarded; interning carries over
+    Scanner_reset(&scanner, CharItr_of_Str(&second));
+    Token wc = Scanner_next(&scanner);
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "wc" }, wc);
+    ASSERT_EQ(Atom_intern_cstr("wc"), Token_atom(&wc));
+    Expected expected[] = {
+        { PIPE_TOKEN, "|" },
+        { WORD_TOKEN, "sort" },
+    };
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
+
+    Scanner_drop(&scanner);
+    ASSERT_FALSE(Scanner_has_next(&scanner));
+    Str_drop(&first);
+    Str_drop(&second);
+}
+
+TEST(ScannerSpec, fill_takes_line_tokens)
+{
+    Str input = Str_from("a b | c d\nnext");
+    Scanner scanner = Scanner_value(CharItr_of_Str(&input));
+    Token tokens[4];
+    ASSERT_EQ(4, Scanner_fill(&scanner, tokens, 4));
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "a" }, tokens[0]);
+    ASSERT_TOKEN_EQ({ PIPE_TOKEN, "|" }, tokens[2]);
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "c" }, tokens[3]);
+
+    // A fill stops at the end of the line
+    ASSERT_EQ(1, Scanner_fill(&scanner, tokens, 4));
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "d" }, tokens[0]);
+    ASSERT_EQ(0, Scanner_fill(&scanner, tokens, 4));
+
+    ASSERT_TRUE(Scanner_next_line(&scanner));
+    ASSERT_EQ(1, Scanner_fill(&scanner, tokens, 4));
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "next" }, tokens[0]);
+    Str_drop(&input);
+}
+
+TEST(ScannerSpec, not_interning_by_default)
+{
+    Scanner scanner = fixture("grep");
+    Token grep = Scanner_next(&scanner);
+    ASSERT_EQ(NULL, Token_atom(&grep));
+}
+
+TEST(ScannerSpec, newline_ends_line)
+{
+    Str input = Str_from("ls -l\n  wc | sort");
+    Scanner scanner = Scanner_value(CharItr_of_Str(&input));
+    Token ls = Scanner_next(&scanner);
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "ls" }, ls);
+
+    // The rest of the first line is discarded
+    ASSERT_TRUE(Scanner_next_line(&scanner));
+    Expected expected[] = {
+        { WORD_TOKEN, "wc" },
+        { PIPE_TOKEN, "|" },
+        { WORD_TOKEN, "sort" },
+    };
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
+    Str_drop(&input);
+}
+
+TEST(ScannerSpec, nul_ends_only_its_line)
+{
+    // Indexed or not, a '\0' skips the rest of its line
+    std::string text("ls -l\0 rm -rf /\nwc\n", 19);
+    std::string padded = text + std::string(1024, ' ') + "\nsort";
+    ASSERT_EQ('\0', text[5]);
+
+    Scanner scanner = Scanner_value(CharItr_value(text.data(), text.size()));
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "ls" }, Scanner_next(&scanner));
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "-l" }, Scanner_next(&scanner));
+    ASSERT_EQ(END_TOKEN, Scanner_next(&scanner).type);
+    ASSERT_TRUE(Scanner_next_line(&scanner));
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "wc" }, Scanner_next(&scanner));
+    ASSERT_FALSE(Scanner_next_line(&scanner));
+
+    Scanner indexed = Scanner_value(CharItr_value(padded.data(), padded.size()));
+    ASSERT_TRUE(indexed.indexed);
+    ASSERT_TRUE(Scanner_next_line(&indexed));
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "wc" }, Scanner_next(&indexed));
+    ASSERT_TRUE(Scanner_next_line(&indexed));
+    ASSERT_FALSE(Scanner_has_next(&indexed));
+    ASSERT_TRUE(Scanner_next_line(&indexed));
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "sort" }, Scanner_next(&indexed));
+}
+
+TEST(ScannerSpec, operators_maximal_munch)
+{
+    Scanner scanner = fixture("a||b&&c&d>e>>f<g|h");
+    Expected expected[] = {
+        { WORD_TOKEN, "a" },
+        { OR_TOKEN, "||" },
+        { WORD_TOKEN, "b" },
+        { AND_TOKEN, "&&" },
+        { WORD_TOKEN, "c" },
+        { BACKGROUND_TOKEN, "&" },
+        { WORD_TOKEN, "d" },
+        { REDIRECT_OUT_TOKEN, ">" },
+        { WORD_TOKEN, "e" },
+        { APPEND_TOKEN, ">>" },
+        { WORD_TOKEN, "f" },
+        { REDIRECT_IN_TOKEN, "<" },
+        { WORD_TOKEN, "g" },
+        { PIPE_TOKEN, "|" },
+        { WORD_TOKEN, "h" },
+    };
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
+}
+
+TEST(ScannerSpec, operator_runs)
+{
+    Scanner scanner = fixture("||| >>> &&&");
+    Expected expected[] = {
+        { OR_TOKEN, "||" },
+        { PIPE_TOKEN, "|" },
+        { APPEND_TOKEN, ">>" },
+        { REDIRECT_OUT_TOKEN, ">" },
+        { AND_TOKEN, "&&" },
+        { BACKGROUND_TOKEN, "&" },
+    };
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
+}
+
+TEST(ScannerSpec, dup_and_digit_words)
+{
+    Scanner scanner = fixture("make 2>&1 | tail -n 20 2>&x 12ab");
+    Expected expected[] = {
+        { WORD_TOKEN, "make" },
+        { DUP_TOKEN, "2>&1" },
+        { PIPE_TOKEN, "|" },
+        { WORD_TOKEN, "tail" },
+        { WORD_TOKEN, "-n" },
+        { WORD_TOKEN, "20" },
+        // No DUP without a target fd: back up to the longest token
+        { WORD_TOKEN, "2" },
+        { REDIRECT_OUT_TOKEN, ">" },
+        { BACKGROUND_TOKEN, "&" },
+        { WORD_TOKEN, "x" },
+        { WORD_TOKEN, "12ab" },
+    };
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
+}
+
+typedef std::vector<std::pair<int, std::string> > Lexed;
+
+static Lexed pull_all(const char *cstr)
+{
+    Lexed lexed;
+    Scanner scanner = Scanner_value(CharItr_value(cstr, strlen(cstr)));
+    while (Scanner_has_next(&scanner)) {
+        Token token = Scanner_next(&scanner);
+        lexed.push_back(std::make_pair(token.type, std::string(token.start, token.length)));
+    }
+    return lexed;
+}
+
+// Feed a PushScanner `chunk` chars at a time, up to the end of input
+static Lexed push_all(const char *cstr, size_t chunk)
+{
+    Lexed lexed;
+    std::string input(cstr);
+    PushScanner scanner = PushScanner_value();
+    size_t fed = 0;
+    Token token;
+    for (;;) {
+        if (PushScanner_next(&scanner, &token) == SCAN_NEED_INPUT) {
+            if (fed == input.size()) {
+                PushScanner_finish(&scanner);
+            } else {
+                size_t length = std::min(chunk, input.size() - fed);
+                PushScanner_feed(&scanner, input.data() + fed, length);
+                fed += length;
+            }
+            continue;
+        }
+        if (token.type == END_TOKEN && fed == input.size() && scanner.finished) {
+            break;
+        }
+        lexed.push_back(std::make_pair(token.type, std::string(token.start, token.length)));
+    }
+    PushScanner_drop(&scanner);
+    return lexed;
+}
+
+TEST(ScannerSpec, push_needs_input)
+{
+    PushScanner scanner = PushScanner_value();
+    Token token;
+    ASSERT_EQ(SCAN_NEED_INPUT, PushScanner_next(&scanner, &token));
+
+    PushScanner_feed(&scanner, "ls gr", 5);
+    ASSERT_EQ(SCAN_TOKEN, PushScanner_next(&scanner, &token));
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "ls" }, token);
+    // The word may go on in the next chunk
+    ASSERT_EQ(SCAN_NEED_INPUT, PushScanner_next(&scanner, &token));
+
+    PushScanner_feed(&scanner, "ep\n", 3);
+    ASSERT_EQ(SCAN_TOKEN, PushScanner_next(&scanner, &token));
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "grep" }, token);
+    ASSERT_EQ(SCAN_TOKEN, PushScanner_next(&scanner, &token));
+    ASSERT_EQ(END_TOKEN, token.type);
+    ASSERT_EQ(SCAN_NEED_INPUT, PushScanner_next(&scanner, &token));
+
+    PushScanner_finish(&scanner);
+    ASSERT_EQ(SCAN_TOKEN, PushScanner_next(&scanner, &token));
+    ASSERT_EQ(END_TOKEN, token.type);
+    PushScanner_drop(&scanner);
+}
+
+TEST(ScannerSpec, push_tokens_are_spans_of_chunk)
+{
+    const char *chunk = "cat notes";
+    PushScanner scanner = PushScanner_value();
+    PushScanner_feed(&scanner, chunk, strlen(chunk));
+    Token token;
+    ASSERT_EQ(SCAN_TOKEN, PushScanner_next(&scanner, &token));
+    ASSERT_EQ(chunk, token.start);
+    PushScanner_drop(&scanner);
+}
+
+TEST(ScannerSpec, push_matches_pull_in_any_chunks)
+{
+    const char *inputs[] = {
+        "grep -v foo | sort -u",
+        "make 2>&1 | tail -n 20 2>&x 12ab",
+        "a||b&&c&d>e>>f<g|h",
+        "||| >>> &&& 2>& 2> 2",
+        "  \t spaced \t out \t ",
+        "echo 'a b' \"c \\\" d\" e\\ f 'open",
+    };
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        Lexed expected = pull_all(inputs[i]);
+        for (size_t chunk = 1; chunk <= strlen(inputs[i]); ++chunk) {
+            ASSERT_EQ(expected, push_all(inputs[i], chunk)) << inputs[i] << " in chunks of " << chunk;
+        }
+    }
+}
+
+TEST(ScannerSpec, push_lines_follow_each_other)
+{
+    Lexed expected;
+    expected.push_back(std::make_pair(WORD_TOKEN, std::string("ls")));
+    expected.push_back(std::make_pair(END_TOKEN, std::string("")));
+    expected.push_back(std::make_pair(END_TOKEN, std::string("")));
+    expected.push_back(std::make_pair(WORD_TOKEN, std::string("wc")));
+    expected.push_back(std::make_pair(END_TOKEN, std::string("")));
+    for (size_t chunk = 1; chunk <= 8; ++chunk) {
+        ASSERT_EQ(expected, push_all("ls\n\nwc\n", chunk));
+    }
+}
+
+TEST(ScannerSpec, quoted_words)
+{
+    Scanner scanner = fixture("echo 'a b' \"c \\\"d\\\" \\e\" f\\ g 'x'\"y\"z a'|'b 2\\>x");
+    Expected expected[] = {
+        { WORD_TOKEN, "echo" },
+        { WORD_TOKEN, "a b" },
+        { WORD_TOKEN, "c \"d\" \\e" },
+        { WORD_TOKEN, "f g" },
+        { WORD_TOKEN, "xyz" },
+        { WORD_TOKEN, "a|b" },
+        { WORD_TOKEN, "2>x" },
+    };
+    ASSERT_TOKENS_EQ(expected, sizeof(expected) / sizeof(Expected), scanner);
+}
+
+TEST(ScannerSpec, quoted_word_view_is_as_written)
+{
+    Scanner scanner = fixture("ls 'my file'");
+    Token ls = Scanner_next(&scanner);
+    Token file = Scanner_next(&scanner);
+    ASSERT_FALSE(ls.quoted);
+    ASSERT_TRUE(file.quoted);
+    StrView view = Token_view(&file);
+    ASSERT_TRUE(StrView_equals_cstr(&view, "'my file'"));
+}
+
+TEST(ScannerSpec, open_quote_runs_to_end_of_line)
+{
+    Str input = Str_from("echo 'a | b\nwc\\");
+    Scanner scanner = Scanner_value(CharItr_of_Str(&input));
+    Token echo = Scanner_next(&scanner);
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "echo" }, echo);
+    Token open = Scanner_next(&scanner);
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "a | b" }, open);
+    ASSERT_FALSE(Scanner_has_next(&scanner));
+
+    // A trailing backslash stands for itself
+    ASSERT_TRUE(Scanner_next_line(&scanner));
+    Token wc = Scanner_next(&scanner);
+    ASSERT_TOKEN_EQ({ WORD_TOKEN, "wc\\" }, wc);
+    Str_drop(&input);
+}
+
+TEST(ScannerSpec, interning_quoted_words)
+{
+    Str input = Str_from("'grep' gr\"ep\"");
+    Scanner scanner = Scanner_interning(CharItr_of_Str(&input));
+    Token first = Scanner_next(&scanner);
+    Token second = Scanner_next(&scanner);
+    ASSERT_EQ(Atom_intern_cstr("grep"), Token_atom(&first));
+    ASSERT_EQ(Token_atom(&first), Token_atom(&second));
+    ASSERT_FALSE(second.quoted);
+    Str_drop(&input);
+}
+
+// Large in-memory inputs go through the structural index; it must
+// produce exactly the tokens the state machine does on short lines.
+TEST(ScannerSpec, indexed_matches_unindexed)
+{
+    static const char *pieces[] = {
+        "ls", "-lah", "2>&1", "2>x", "12", "7>&", "|", "||", "&&", "&", ">", ">>", "<",
+        " ", "  ", "\t", "a", "grep", "x>y", "2>&1x", "\n", "\n\n",
+        "'a b'", "\"c|d\"", "e\\ f", "x'y z'w", "'", "\\",
+    };
+    size_t count = sizeof(pieces) / sizeof(pieces[0]);
+    Str input = Str_value(0);
+    unsigned seed = 12345;
+    while (Str_length(&input) < 20000) {
+        seed = seed * 1103515245 + 12345;
+        size_t pick = (seed >> 16) % (count + 1);
+        if (pick == count) {
+            // A word long enough to cross index windows
+            for (int i = 0; i < 300; ++i) {
+                Str_append(&input, "w");
+            }
+            // Keep lines short enough that the reference stays unindexed
+            Str_append(&input, "\n");
+        } else {
+            Str_append(&input, pieces[pick]);
+        }
+        Str_append(&input, (seed >> 8) % 3 == 0 ? "" : " ");
+    }
+
+    Scanner indexed = Scanner_value(CharItr_of_Str(&input));
+    ASSERT_TRUE(indexed.indexed);
+
+    const char *line = Str_cstr(&input);
+    const char *end = line + Str_length(&input);
+    size_t tokens = 0;
+    while (line < end) {
+        const char *newline = (const char*) memchr(line, '\n', end - line);
+        size_t length = (newline != NULL ? newline : end) - line;
+        ASSERT_LT(length, 1024);
+        Scanner reference = Scanner_value(CharItr_value(line, length));
+        ASSERT_FALSE(reference.indexed);
+        while (Scanner_has_next(&reference)) {
+            ASSERT_TRUE(Scanner_has_next(&indexed));
+            Token expect = Scanner_next(&reference);
+            Token actual = Scanner_next(&indexed);
+            ASSERT_TOKEN_EQ(expect, actual);
+            tokens++;
+        }
+        ASSERT_FALSE(Scanner_has_next(&indexed));
+        line += length + 1;
+        if (line < end) {
+            ASSERT_TRUE(Scanner_next_line(&indexed));
+        }
+    }
+    ASSERT_GT(tokens, 1000);
+    Str_drop(&input);
 }
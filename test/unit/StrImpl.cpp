@@ -250,3 +250,54 @@ TEST(StrImpl, set_out_of_bounds)
 
 	Str_drop(&s);
 }
+
+TEST(StrImpl, inline_value)
+{
+	Str s = Str_inline();
+	ASSERT_EQ(0, Str_length(&s));
+	ASSERT_EQ(nullptr, s.buffer);
+	ASSERT_STREQ("", Str_cstr(&s));
+	Str_drop(&s);
+}
+
+TEST(StrImpl, inline_append_and_spill)
+{
+	Str s = Str_inline();
+	Str_append(&s, "abcd");
+	ASSERT_EQ(nullptr, s.buffer);
+	ASSERT_STREQ("abcd", Str_cstr(&s));
+
+	Str_append(&s, "efghijklmnopqrstuvwxyz");
+	ASSERT_NE(nullptr, s.buffer);
+	ASSERT_STREQ("abcdefghijklmnopqrstuvwxyz", Str_cstr(&s));
+
+	Str expected = Str_from("abcdefghijklmnopqrstuvwxyz");
+	ASSERT_TRUE(Vec_equals(&s, &expected));
+
+	Str_drop(&s);
+	Str_drop(&expected);
+}
+
+TEST(StrImpl, inline_from_n_short)
+{
+	Str s = Str_inline_from_n("grep --color", 6);
+	ASSERT_EQ(nullptr, s.buffer);
+	ASSERT_EQ(6, Str_length(&s));
+	ASSERT_STREQ("grep -", Str_cstr(&s));
+	Str_drop(&s);
+}
+
+TEST(StrImpl, inline_from_n_longest_inline)
+{
+	const char *input = "abcdefghijklmnopqrstuvwxyz";
+	Str s = Str_inline_from_n(input, VEC_INLINE_BYTES - 1);
+	ASSERT_EQ(nullptr, s.buffer);
+	ASSERT_EQ(VEC_INLINE_BYTES - 1, Str_length(&s));
+	Str_drop(&s);
+
+	s = Str_inline_from_n(input, VEC_INLINE_BYTES);
+	ASSERT_NE(nullptr, s.buffer);
+	ASSERT_EQ(VEC_INLINE_BYTES, Str_length(&s));
+	ASSERT_EQ(0, strncmp(input, Str_cstr(&s), VEC_INLINE_BYTES));
+	Str_drop(&s);
+}
@@ -102,3 +102,38 @@ TEST(StrSpec, append_equality) {
 }
 
 
+TEST(StrSpec, from_n_contract) {
+	Str s = Str_from_n("hello world", 5);
+
+	ASSERT_EQ(5, Str_length(&s));
+	ASSERT_STREQ("hello", Str_cstr(&s));
+
+	Str_drop(&s);
+}
+
+TEST(StrSpec, append_n_contract) {
+	Str s = Str_from("app");
+
+	Str_append_n(&s, "lesauce", 3);
+	ASSERT_EQ(6, Str_length(&s));
+	ASSERT_STREQ("apples", Str_cstr(&s));
+
+	Str_append_n(&s, "", 0);
+	ASSERT_STREQ("apples", Str_cstr(&s));
+
+	Str_drop(&s);
+}
+
+TEST(StrSpec, append_str_contract) {
+	Str s = Str_from("race");
+	Str other = Str_from("car");
+
+	Str_append_str(&s, &other);
+	ASSERT_EQ(7, Str_length(&s));
+	ASSERT_STREQ("racecar", Str_cstr(&s));
+	ASSERT_STREQ("car", Str_cstr(&other));
+
+	Str_drop(&s);
+	Str_drop(&other);
+}
+
@@ -0,0 +1,27 @@
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "StrVec.h"
+}
+
+TEST(StrVecSpec, push_pop) {
+    StrVec v = StrVec_value(1);
+    StrVec_push(&v, Str_from("a"));
+    StrVec_push(&v, Str_from("b"));
+    ASSERT_EQ(2, StrVec_length(&v));
+    Str b = StrVec_pop(&v);
+    ASSERT_STREQ("b", Str_cstr(&b));
+    ASSERT_EQ(1, StrVec_length(&v));
+    Str_drop(&b);
+    StrVec_drop(&v);
+}
+
+TEST(StrVecSpec, drop_heap_strs) {
+    StrVec v = StrVec_value(1);
+    for (int i = 0; i < 100; ++i) {
+        StrVec_push(&v, Str_from("a string too long to be stored inline"));
+    }
+    StrVec_drop(&v);
+    ASSERT_EQ(0, StrVec_length(&v));
+    ASSERT_EQ(0, Vec_capacity(&v));
+}
@@ -0,0 +1,146 @@
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "StrView.h"
+#include "CharItr.h"
+#include "Map.h"
+#include "Parser.h"
+}
+
+/**
+ * Contract tests for the borrowed StrView slice type.
+ */
+
+TEST(StrViewSpec, from_cstr) {
+    StrView v = StrView_from_cstr("abc");
+    ASSERT_EQ(3, StrView_length(&v));
+    ASSERT_EQ('a', StrView_get(&v, 0));
+    ASSERT_EQ('c', StrView_get(&v, 2));
+}
+
+TEST(StrViewSpec, of_Str_borrows) {
+    Str s = Str_from("hello");
+    StrView v = StrView_of_Str(&s);
+    ASSERT_EQ(Str_cstr(&s), v.start);
+    ASSERT_EQ(5, StrView_length(&v));
+    Str_drop(&s);
+}
+
+TEST(StrViewSpec, to_Str_copies) {
+    StrView v = StrView_value("hello world", 5);
+    Str s = StrView_to_Str(&v);
+    ASSERT_STREQ("hello", Str_cstr(&s));
+    Str_drop(&s);
+}
+
+TEST(StrViewSpec, get_out_of_bounds) {
+    StrView v = StrView_from_cstr("ab");
+    ASSERT_EXIT(StrView_get(&v, 2), ::testing::ExitedWithCode(EXIT_FAILURE), ".* - Out of Bounds");
+}
+
+TEST(StrViewSpec, slice) {
+    StrView v = StrView_from_cstr("hello world");
+    StrView w = StrView_slice(&v, 6, 5);
+    ASSERT_TRUE(StrView_equals_cstr(&w, "world"));
+    StrView empty = StrView_slice(&v, 11, 0);
+    ASSERT_EQ(0, StrView_length(&empty));
+}
+
+TEST(StrViewSpec, slice_out_of_bounds) {
+    StrView v = StrView_from_cstr("hello");
+    ASSERT_EXIT(StrView_slice(&v, 3, 3), ::testing::ExitedWithCode(EXIT_FAILURE), ".* - Out of Bounds");
+}
+
+TEST(StrViewSpec, equals) {
+    StrView a = StrView_value("abcd", 3);
+    StrView b = StrView_from_cstr("abc");
+    StrView c = StrView_from_cstr("abd");
+    ASSERT_TRUE(StrView_equals(&a, &b));
+    ASSERT_FALSE(StrView_equals(&a, &c));
+    ASSERT_TRUE(StrView_equals_cstr(&a, "abc"));
+    ASSERT_FALSE(StrView_equals_cstr(&a, "ab"));
+    ASSERT_FALSE(StrView_equals_cstr(&a, "abcd"));
+}
+
+TEST(StrViewSpec, equals_cstr_with_embedded_nul) {
+    StrView v = StrView_value("ab\0cd", 5);
+    ASSERT_FALSE(StrView_equals_cstr(&v, "ab"));
+    StrView ab = StrView_value("ab\0cd", 2);
+    ASSERT_TRUE(StrView_equals_cstr(&ab, "ab"));
+}
+
+TEST(StrViewSpec, compare) {
+    StrView ab = StrView_from_cstr("ab");
+    StrView abc = StrView_from_cstr("abc");
+    StrView b = StrView_from_cstr("b");
+    ASSERT_LT(StrView_compare(&ab, &abc), 0);
+    ASSERT_GT(StrView_compare(&abc, &ab), 0);
+    ASSERT_LT(StrView_compare(&abc, &b), 0);
+    ASSERT_EQ(0, StrView_compare(&ab, &ab));
+}
+
+TEST(StrViewSpec, hash_agrees_with_str_map) {
+    Map m = Map_str_value(sizeof(int));
+    int one = 1;
+    Str key = Str_from("echo");
+    Map_set(&m, &key, &one);
+    StrView v = StrView_value("echo hi", 4);
+    ASSERT_EQ(Map_hash_bytes("echo", 4), StrView_hash(&v));
+    ASSERT_EQ(1, *(int*) Map_get_str(&m, v.start, v.length));
+    Map_drop(&m);
+}
+
+TEST(StrViewSpec, find) {
+    StrView v = StrView_from_cstr("ls | wc");
+    ASSERT_EQ(3, StrView_find(&v, '|'));
+    ASSERT_EQ(STR_VIEW_NPOS, StrView_find(&v, '>'));
+    ASSERT_EQ(2, StrView_find_any(&v, "|\t "));
+    ASSERT_EQ(STR_VIEW_NPOS, StrView_find_any(&v, "<>"));
+}
+
+TEST(StrViewSpec, find_view) {
+    StrView v = StrView_from_cstr("aababc");
+    StrView abc = StrView_from_cstr("abc");
+    StrView abd = StrView_from_cstr("abd");
+    StrView empty = StrView_from_cstr("");
+    StrView longer = StrView_from_cstr("aababcx");
+    ASSERT_EQ(3, StrView_find_view(&v, &abc));
+    ASSERT_EQ(STR_VIEW_NPOS, StrView_find_view(&v, &abd));
+    ASSERT_EQ(0, StrView_find_view(&v, &empty));
+    ASSERT_EQ(STR_VIEW_NPOS, StrView_find_view(&v, &longer));
+}
+
+TEST(StrViewSpec, split) {
+    StrView rest = StrView_from_cstr("  ls -l\t|  wc ");
+    StrView field;
+    const char *expected[] = { "ls", "-l", "|", "wc" };
+    size_t count = 0;
+    while (StrView_split(&rest, " \t", &field)) {
+        ASSERT_LT(count, 4);
+        ASSERT_TRUE(StrView_equals_cstr(&field, expected[count]));
+        count++;
+    }
+    ASSERT_EQ(4, count);
+    ASSERT_EQ(0, StrView_length(&rest));
+}
+
+TEST(StrViewSpec, split_empty) {
+    StrView rest = StrView_from_cstr("");
+    StrView field;
+    ASSERT_FALSE(StrView_split(&rest, " ", &field));
+}
+
+TEST(StrViewSpec, char_itr_of_view) {
+    StrView v = StrView_value("abc", 2);
+    CharItr itr = CharItr_of_StrView(&v);
+    ASSERT_EQ('a', CharItr_next(&itr));
+    ASSERT_EQ('b', CharItr_next(&itr));
+    ASSERT_FALSE(CharItr_has_next(&itr));
+}
+
+TEST(StrViewSpec, parse_view) {
+    StrView input = StrView_value("ls -l | wc trailing", 10);
+    Node *ast = parse_view(&input);
+    ASSERT_EQ(PIPE_NODE, ast->type);
+    Node_drop(ast);
+}
@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "stdint.h"
+#include "Vec.h"
+#include "TypedVec.h"
+
+VEC_DEFINE(int16_t, I16Vec)
+}
+
+/**
+ * Typed accessors must agree with the untyped Vec API on the
+ * same Vec value.
+ */
+
+TEST(TypedVecSpec, append_load_contract) {
+	Vec v = Vec_value(1, sizeof(int16_t));
+	I16Vec_append(&v, 100);
+	I16Vec_append(&v, 200);
+	I16Vec_append(&v, 300);
+	ASSERT_EQ(3, Vec_length(&v));
+
+	int16_t out = 0;
+	Vec_get(&v, 1, &out);
+	ASSERT_EQ(200, out);
+	ASSERT_EQ(100, I16Vec_load(&v, 0));
+	ASSERT_EQ(300, I16Vec_load(&v, 2));
+	ASSERT_EQ(Vec_ref(&v, 2), I16Vec_at(&v, 2));
+
+	Vec_drop(&v);
+}
+
+TEST(TypedVecSpec, store_contract) {
+	Vec v = Vec_value(1, sizeof(int16_t));
+	int16_t x = 10;
+	Vec_set(&v, 0, &x);
+
+	I16Vec_store(&v, 0, 20);
+	I16Vec_store(&v, 1, 30);
+	ASSERT_EQ(2, Vec_length(&v));
+	ASSERT_EQ(20, I16Vec_load(&v, 0));
+	ASSERT_EQ(30, I16Vec_load(&v, 1));
+
+	Vec_drop(&v);
+}
+
+TEST(TypedVecSpec, out_of_bounds) {
+	Vec v = Vec_value(1, sizeof(int16_t));
+	I16Vec_append(&v, 1);
+
+	ASSERT_DEATH({
+		I16Vec_load(&v, 1);
+	}, ".* - Out of Bounds");
+	ASSERT_DEATH({
+		I16Vec_store(&v, 2, 1);
+	}, ".* - Out of Bounds");
+
+	Vec_drop(&v);
+}
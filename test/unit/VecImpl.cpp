@@ -540,3 +540,272 @@ TEST(VecImpl, splice_delete_all_then_insert) {
 
 	Vec_drop(&v);
 }
+
+TEST(VecImpl, reserve_grows_capacity) {
+	Vec v = Vec_value(1, sizeof(int16_t));
+	Vec_reserve(&v, 8);
+	ASSERT_EQ(0, v.length);
+	ASSERT_EQ(8, v.capacity);
+
+	// Never shrinks
+	Vec_reserve(&v, 2);
+	ASSERT_EQ(8, v.capacity);
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, extend_basic) {
+	Vec v = Vec_value(1, sizeof(int16_t));
+	int16_t a[] = {100, 200, 300};
+
+	Vec_extend(&v, a, 3);
+	ASSERT_EQ(3, v.length);
+	ASSERT_GE(v.capacity, 3);
+
+	Vec_extend(&v, a, 2);
+	ASSERT_EQ(5, v.length);
+
+	int16_t *buffer = (int16_t*)v.buffer;
+	ASSERT_EQ(100, buffer[0]);
+	ASSERT_EQ(200, buffer[1]);
+	ASSERT_EQ(300, buffer[2]);
+	ASSERT_EQ(100, buffer[3]);
+	ASSERT_EQ(200, buffer[4]);
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, push_basic) {
+	Vec v = Vec_value(1, sizeof(int16_t));
+	int16_t x = 1;
+	int16_t y = 2;
+
+	Vec_push(&v, &x);
+	Vec_push(&v, &y);
+	ASSERT_EQ(2, v.length);
+
+	int16_t *buffer = (int16_t*)v.buffer;
+	ASSERT_EQ(x, buffer[0]);
+	ASSERT_EQ(y, buffer[1]);
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, truncate_basic) {
+	Vec v = Vec_value(4, sizeof(int16_t));
+	int16_t a[] = {100, 200, 300, 400};
+	Vec_extend(&v, a, 4);
+
+	Vec_truncate(&v, 1);
+	ASSERT_EQ(1, v.length);
+	ASSERT_EQ(4, v.capacity);
+	ASSERT_EQ(100, ((int16_t*)v.buffer)[0]);
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, truncate_out_of_bounds) {
+	Vec v = Vec_value(4, sizeof(int16_t));
+	int16_t a[] = {100, 200};
+	Vec_extend(&v, a, 2);
+
+	ASSERT_DEATH({
+		Vec_truncate(&v, 3);
+	}, ".* - Out of Bounds");
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, spare_then_set_length) {
+	Vec v = Vec_value(4, sizeof(int16_t));
+	int16_t a[] = {100};
+	Vec_extend(&v, a, 1);
+
+	int16_t *spare = (int16_t*) Vec_spare(&v);
+	ASSERT_EQ((int16_t*)v.buffer + 1, spare);
+	spare[0] = 200;
+	spare[1] = 300;
+	Vec_set_length(&v, 3);
+	ASSERT_EQ(3, v.length);
+	ASSERT_EQ(300, ((int16_t*)v.buffer)[2]);
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, set_length_out_of_bounds) {
+	Vec v = Vec_value(4, sizeof(int16_t));
+
+	ASSERT_DEATH({
+		Vec_set_length(&v, 5);
+	}, ".* - Out of Bounds");
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, inline_value) {
+	Vec v = Vec_inline(sizeof(int16_t));
+	ASSERT_EQ(0, v.length);
+	ASSERT_EQ(VEC_INLINE_BYTES / sizeof(int16_t), v.capacity);
+	ASSERT_EQ(nullptr, v.buffer);
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, inline_stays_inline) {
+	Vec v = Vec_inline(sizeof(int16_t));
+	int16_t a[] = {100, 200, 300};
+	Vec_extend(&v, a, 3);
+
+	ASSERT_EQ(nullptr, v.buffer);
+	ASSERT_EQ((void*)v.inline_buffer, Vec_ref(&v, 0));
+	int16_t *items = (int16_t*)v.inline_buffer;
+	ASSERT_EQ(100, items[0]);
+	ASSERT_EQ(300, items[2]);
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, inline_spills_to_heap) {
+	Vec v = Vec_inline(sizeof(int16_t));
+	size_t inline_capacity = v.capacity;
+	for (int16_t i = 0; i <= (int16_t) inline_capacity; ++i) {
+		Vec_push(&v, &i);
+	}
+
+	ASSERT_NE(nullptr, v.buffer);
+	ASSERT_EQ(inline_capacity + 1, v.length);
+	int16_t *buffer = (int16_t*)v.buffer;
+	for (int16_t i = 0; i <= (int16_t) inline_capacity; ++i) {
+		ASSERT_EQ(i, buffer[i]);
+	}
+
+	Vec_drop(&v);
+	ASSERT_EQ(nullptr, v.buffer);
+	ASSERT_EQ(0, v.capacity);
+}
+
+TEST(VecImpl, shrink_to_fit_heap) {
+	Vec v = Vec_value(64, sizeof(int32_t));
+	int32_t a[] = {1, 2, 3, 4, 5, 6, 7, 8};
+	Vec_extend(&v, a, 8);
+
+	Vec_shrink_to_fit(&v);
+	ASSERT_EQ(8, v.capacity);
+	ASSERT_NE(nullptr, v.buffer);
+	ASSERT_EQ(8, ((int32_t*)v.buffer)[7]);
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, shrink_to_fit_moves_inline) {
+	Vec v = Vec_value(64, sizeof(int16_t));
+	int16_t a[] = {100, 200};
+	Vec_extend(&v, a, 2);
+
+	Vec_shrink_to_fit(&v);
+	ASSERT_EQ(nullptr, v.buffer);
+	ASSERT_EQ(VEC_INLINE_BYTES / sizeof(int16_t), v.capacity);
+	ASSERT_EQ(2, v.length);
+	ASSERT_EQ(200, ((int16_t*)v.inline_buffer)[1]);
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, shrink_to_keeps_requested_capacity) {
+	Vec v = Vec_value(1024, sizeof(char));
+	Vec_extend(&v, "abc", 3);
+
+	Vec_shrink_to(&v, 80);
+	ASSERT_EQ(80, v.capacity);
+	ASSERT_NE(nullptr, v.buffer);
+
+	// Never grows
+	Vec_shrink_to(&v, 200);
+	ASSERT_EQ(80, v.capacity);
+
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, growth_policy) {
+	VecGrowth policy = { 3, 2, 64 };
+	ASSERT_TRUE(Vec_set_growth(&policy));
+
+	Vec v = Vec_value(1, sizeof(int32_t));
+	int32_t a[] = {1, 2, 3, 4, 5};
+	Vec_extend(&v, a, 5);
+	// 5 * 3 / 2 = 7 items = 28 bytes, rounded up to 64 bytes = 16 items
+	ASSERT_EQ(16, v.capacity);
+	Vec_drop(&v);
+
+	Vec_set_growth(NULL);
+	ASSERT_EQ(2, Vec_growth().factor_numerator);
+	ASSERT_EQ(1, Vec_growth().factor_denominator);
+	ASSERT_EQ(0, Vec_growth().round_bytes);
+}
+
+TEST(VecImpl, growth_policy_rejects_shrinking_factors) {
+	VecGrowth zero = { 2, 0, 0, 0 };
+	ASSERT_FALSE(Vec_set_growth(&zero));
+	VecGrowth below_one = { 1, 2, 0, 0 };
+	ASSERT_FALSE(Vec_set_growth(&below_one));
+	// The default policy is kept
+	ASSERT_EQ(2, Vec_growth().factor_numerator);
+	ASSERT_EQ(1, Vec_growth().factor_denominator);
+
+	Vec v = Vec_value(1, sizeof(int32_t));
+	int32_t a[] = {1, 2};
+	Vec_extend(&v, a, 2);
+	ASSERT_EQ(4, v.capacity);
+	Vec_drop(&v);
+}
+
+TEST(VecImpl, item_size_too_large) {
+	ASSERT_DEATH({
+		Vec_value(0, (size_t) UINT32_MAX + 1);
+	}, ".* - Item size too large");
+	ASSERT_DEATH({
+		Vec_inline((size_t) UINT32_MAX + 1);
+	}, ".* - Item size too large");
+}
+
+TEST(VecImpl, large_buffer_mode) {
+	VecGrowth policy = Vec_growth();
+	policy.map_threshold = 4096;
+	Vec_set_growth(&policy);
+
+	Vec v = Vec_value(1, sizeof(int32_t));
+	for (int32_t i = 0; i < 10000; ++i) {
+		Vec_push(&v, &i);
+	}
+	ASSERT_TRUE(v.mapped);
+	for (int32_t i = 0; i < 10000; ++i) {
+		ASSERT_EQ(i, ((int32_t*)v.buffer)[i]);
+	}
+
+	Vec_truncate(&v, 2000);
+	Vec_shrink_to_fit(&v);
+	ASSERT_TRUE(v.mapped);
+	ASSERT_GE(v.capacity, 2000);
+	ASSERT_EQ(1999, ((int32_t*)v.buffer)[1999]);
+
+	Vec_drop(&v);
+	ASSERT_FALSE(v.mapped);
+	ASSERT_EQ(nullptr, v.buffer);
+
+	Vec_set_growth(NULL);
+}
+
+TEST(VecImpl, large_buffer_mode_skips_custom_allocators) {
+	VecGrowth policy = Vec_growth();
+	policy.map_threshold = 4096;
+	Vec_set_growth(&policy);
+
+	Allocator allocator = *Allocator_system();
+	Vec v = Vec_value_in(1, sizeof(int32_t), &allocator);
+	for (int32_t i = 0; i < 10000; ++i) {
+		Vec_push(&v, &i);
+	}
+	ASSERT_FALSE(v.mapped);
+	Vec_drop(&v);
+
+	Vec_set_growth(NULL);
+}